@@ -0,0 +1,163 @@
+#include <iostream>
+#include <thread>
+
+#include "app.hpp"
+#include "memory_pool.hpp"
+#include "trace.hpp"
+
+ButtonLedApp::ButtonLedApp(LedDevice& led1, LedDevice& led2, ButtonDevice& button,
+                           SmartClient& client, const std::string& ip, int port)
+    : led1_(led1), led2_(led2), button_(button), client_(client), ip_(ip), port_(port) {
+    led2_.switchOFF();
+    led1_.blink(2);
+}
+
+void ButtonLedApp::setupSensor(const SensorAcquisition* acquisition) {
+    acquisition_ = acquisition;
+}
+
+void ButtonLedApp::setupIngest(const ShmIngest* ingest) {
+    ingest_ = ingest;
+}
+
+void ButtonLedApp::setLoopPeriod(std::chrono::milliseconds period) {
+    loop_period_ = period;
+}
+
+const std::string& ButtonLedApp::getStatement() const {
+    return statement_;
+}
+
+int ButtonLedApp::getConnectionAttempts() const {
+    return connection_attempts_;
+}
+
+void ButtonLedApp::run(const std::atomic<bool>& running) {
+    Tracer::setThreadName("main");
+    while (running) {
+        if (step()) {
+            std::this_thread::sleep_for(loop_period_);
+        }
+    }
+}
+
+bool ButtonLedApp::step() {
+    {
+        HeapAllowedScope heap_allowed; // дамп по SIGUSR1 - не рабочий цикл
+        Tracer::dumpIfRequested(TRACE_DEFAULT_PATH);
+    }
+
+    bool eth_link_is_up = client_.checkEthernetLink();
+
+    if(eth_link_is_up == false && eth_link_was_up_ == true){
+        TRACE_SCOPE("link_down", 0, TRACE_FLOW_NONE);
+        std::cerr << "[MAIN] ETH0 LINK DOWN - Cable disconnected!" << std::endl;
+        statement_ = "alert";
+        if (client_.isRunning()) {
+            client_.stop();
+        }
+        led1_.switchON();
+    }
+    else if (eth_link_was_up_ == false && eth_link_is_up == true) {
+        // Кабель подключен
+        std::cout << "[MAIN] ETH0 LINK UP - Cable connected" << std::endl;
+    }
+
+    eth_link_was_up_ = eth_link_is_up;
+
+    if(statement_ == "normal")
+    {
+        if (!client_.isRunning())
+        {
+            HeapAllowedScope heap_allowed; // подключение - не стабильный режим
+            TRACE_SCOPE("client_start", button_trace_id_, TRACE_FLOW_STEP);
+            std::cout << "Starting client..." << std::endl;
+            if (client_.start(ip_, port_)) {
+                std::cout << "Client started successfully" << std::endl;
+                connection_attempts_ = 0;
+                TRACE_SCOPE("led_connected", button_trace_id_, TRACE_FLOW_END);
+                button_trace_id_ = 0;
+                led2_.switchOFF();
+                led1_.switchON();
+            } else {
+                std::cout << "Failed to start client" << std::endl;
+                connection_attempts_++;
+            }
+        }
+
+        if(!client_.isConnected()){
+            std::cerr << "[MAIN] Ethernet connection lost!" << std::endl;
+            client_.stop();
+            connection_attempts_++;
+            if (connection_attempts_ >= APP_MAX_ATTEMPTS) {
+                std::cerr << "[MAIN] Too many failed attempts, switching to ALERT" << std::endl;
+                statement_ = "alert";
+                return false;
+            }
+            led1_.blink(2); // rk_func_boot_connection_stop
+            led2_.switchOFF();
+        }
+        else{
+            RuntimeMemory::enterSteadyState();
+            if(connection_attempts_ > 0){
+                auto now = std::chrono::steady_clock::now();
+                // Как static-переменная в прежнем main(): отсчет с первого попадания сюда
+                if (!last_reset_time_set_) {
+                    last_reset_time_ = now;
+                    last_reset_time_set_ = true;
+                }
+                if (std::chrono::duration_cast<std::chrono::seconds>(now - last_reset_time_).count() > 10) {
+                    std::cout << "[MAIN] Connection stable for 10s, resetting attempt counter" << std::endl;
+                    connection_attempts_ = 0;
+                    last_reset_time_ = now;
+                }
+            }
+        }
+    }
+    else if(statement_ == "alert")
+    {
+        led1_.blink(2); // rk_func_boot_connection_stop
+        led2_.switchOFF();
+        std::cout << "[ETHERNET] Catched ETH disconnection" << std::endl;
+        if (client_.isRunning()) {
+            std::cout << "[MAIN] Stopping client in ALERT mode" << std::endl;
+            client_.stop();
+        }
+    }// alert end if
+
+    bool button_is_pressed = button_.isPressed();
+    if (button_is_pressed && !button_was_pressed_) {
+        button_trace_id_ = TRACE_NEW_ID();
+        TRACE_SCOPE("gpio_edge", button_trace_id_, TRACE_FLOW_START);
+    }
+    button_was_pressed_ = button_is_pressed;
+
+    if(button_is_pressed) { // rk_func_sensor_alert_reaction
+        std::cout << "[MAIN] Button pressed" << std::endl;
+        if(statement_ == "alert") {
+            TRACE_SCOPE("state_normal", button_trace_id_, TRACE_FLOW_STEP);
+            std::cout << "[MAIN] switching to NORMAL" << std::endl;
+            statement_ = "normal";
+            connection_attempts_ = 0;
+        }
+    }
+
+    DeliveryStats delivery = client_.getDeliveryStats();
+    ShmIngestStats ingest = ingest_ ? ingest_->getStats() : ShmIngestStats();
+    std::cout   << "[STATUS] State: " << statement_
+                << ", ETH running: " << client_.isRunning()
+                << ", ETH connected: " << client_.isConnected()
+                << ", Attempts: " << connection_attempts_
+                << ", Frames: " << (acquisition_ ? acquisition_->getStats().frames : 0)
+                << ", Ingest: " << ingest.frames << " (dropped " << ingest.dropped_frames
+                << ", ring full " << ingest.ring_full << ")"
+                << ", IO: " << client_.getIoBackendName()
+                << ", Codec: " << client_.getCodecName()
+                << " (x" << client_.getCompressionStats().ratio() << ")"
+                << ", Acked: " << delivery.acked << " (in flight " << delivery.in_flight
+                << ", RTT " << delivery.srtt_ms << " ms)"
+                << ", Failovers: " << delivery.failovers
+                << ", Dropped: " << delivery.dropped
+                << ", Steady heap allocs: " << RuntimeMemory::steadyStateAllocations() << std::endl;
+    return true;
+}
@@ -0,0 +1,59 @@
+#ifndef APP_MODULE_HPP
+#define APP_MODULE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <string>
+
+#include "hal.hpp"
+#include "ethernet.hpp"
+#include "sensor.hpp"
+#include "shm_ingest.hpp"
+
+#define APP_LOOP_PERIOD_MS 500
+#define APP_MAX_ATTEMPTS 5
+
+/*
+ * Машина состояний из main(): кнопка -> состояние -> светодиоды -> сеть.
+ * Работает только через интерфейсы hal.hpp, поэтому одинаково запускается
+ * на плате (sysfs) и на x86 с симуляцией (hal_sim.hpp).
+ */
+class ButtonLedApp {
+public:
+    ButtonLedApp(LedDevice& led1, LedDevice& led2, ButtonDevice& button,
+                 SmartClient& client, const std::string& ip, int port);
+
+    // Одна итерация цикла; false - повторить сразу, без паузы
+    bool step();
+    void run(const std::atomic<bool>& running);
+
+    void setupSensor(const SensorAcquisition* acquisition);
+    void setupIngest(const ShmIngest* ingest);
+    void setLoopPeriod(std::chrono::milliseconds period);
+    const std::string& getStatement() const;
+    int getConnectionAttempts() const;
+
+    ButtonLedApp(const ButtonLedApp&) = delete;
+    ButtonLedApp& operator=(const ButtonLedApp&) = delete;
+
+private:
+    LedDevice& led1_;
+    LedDevice& led2_;
+    ButtonDevice& button_;
+    SmartClient& client_;
+    std::string ip_;
+    int port_;
+    const SensorAcquisition* acquisition_ = nullptr;
+    const ShmIngest* ingest_ = nullptr;
+
+    std::chrono::milliseconds loop_period_{APP_LOOP_PERIOD_MS};
+    std::string statement_ = "normal";
+    int connection_attempts_ = 0;
+    bool eth_link_was_up_ = true;
+    bool button_was_pressed_ = false;
+    uint64_t button_trace_id_ = 0;   // событие нажатия для трассировки
+    std::chrono::steady_clock::time_point last_reset_time_;
+    bool last_reset_time_set_ = false;
+};
+
+#endif
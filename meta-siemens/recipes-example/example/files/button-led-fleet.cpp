@@ -0,0 +1,204 @@
+/*
+ * button-led-fleet: нагрузочный тест коллектора тысячами виртуальных плат.
+ *
+ * Устройства (fleet.hpp) делятся между несколькими потоками epoll; каждое
+ * подключается, договаривается о кодеке/ACK, шлет кадры датчика и PING,
+ * переподключается так же, как button-led. Раз в --report-s секунд
+ * печатается сводка, в конце - времена подключения и RTT до ACK.
+ * Код возврата 1, если ни одно устройство не подключилось; 2 - неизвестный
+ * параметр или плохое значение.
+ *
+ * Параметры: --ip A  --port P  --devices N  --threads T  --duration-s S
+ *            --rate HZ  --samples K  --ramp-ms M  --flap-every-ms F  --flap-for-ms D
+ *            --alert-hold-ms H  --compress 0|1  --ack 0|1  --report-s R
+ */
+
+#include <iostream>
+#include <cerrno>
+#include <cstring>
+#include <cstdlib>
+#include <csignal>
+#include <memory>
+#include <vector>
+#include <sys/resource.h>
+
+#include "fleet.hpp"
+
+using namespace std::chrono;
+
+static std::atomic<bool> fleet_running{true};
+
+static void signalHandler(int) {
+    fleet_running = false;
+}
+
+static FleetStats collect(const std::vector<std::unique_ptr<FleetWorker>>& workers) {
+    FleetStats total;
+    for (const auto& worker : workers) {
+        total.merge(worker->getStats());
+    }
+    return total;
+}
+
+static void printLatency(const char* name, const LatencyHistogram& histogram) {
+    if (histogram.count() == 0) {
+        std::cout << "[FLEET] " << name << ": no samples" << std::endl;
+        return;
+    }
+    std::cout << "[FLEET] " << name << ": p50 " << histogram.percentileMs(50)
+              << " ms, p90 " << histogram.percentileMs(90)
+              << " ms, p99 " << histogram.percentileMs(99)
+              << " ms, max " << histogram.maxMs() << " ms ("
+              << histogram.count() << " samples)" << std::endl;
+}
+
+// Каждое устройство - сокет: поднимаем лимит дескрипторов до жесткого
+static void raiseFdLimit(unsigned int devices) {
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) < 0) return;
+
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+    if (limit.rlim_cur != RLIM_INFINITY && limit.rlim_cur < devices + 64) {
+        std::cerr << "[FLEET] Warning: fd limit " << limit.rlim_cur << " is below "
+                  << devices << " devices" << std::endl;
+    }
+}
+
+static void printUsage(std::ostream& out) {
+    out << "Usage: button-led-fleet [--ip A] [--port P] [--devices N] [--threads T] [--duration-s S]\n"
+           "       [--rate HZ] [--samples K] [--ramp-ms M] [--flap-every-ms F] [--flap-for-ms D]\n"
+           "       [--alert-hold-ms H] [--compress 0|1] [--ack 0|1] [--report-s R]" << std::endl;
+}
+
+// Целое min..max без мусора после числа
+static bool parseUnsigned(const char* text, long long min, long long max, unsigned int& out) {
+    char* end = nullptr;
+    errno = 0;
+    long long value = strtoll(text, &end, 10);
+    if (end == text || *end != '\0' || errno != 0 || value < min || value > max) {
+        return false;
+    }
+    out = static_cast<unsigned int>(value);
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    FleetConfig config;
+    unsigned int duration_s = 30;
+    unsigned int report_s = 5;
+
+    for (int i = 1; i < argc; i += 2) {
+        if (strcmp(argv[i], "--help") == 0) {
+            printUsage(std::cout);
+            return 0;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "[FLEET] Missing value for " << argv[i] << std::endl;
+            printUsage(std::cerr);
+            return 2;
+        }
+        const char* option = argv[i];
+        const char* value = argv[i + 1];
+        unsigned int number = 0;
+        bool valid = true;
+        if (strcmp(option, "--ip") == 0) {
+            config.ip = value;
+        } else if (strcmp(option, "--port") == 0) {
+            valid = parseUnsigned(value, 1, 65535, number);
+            config.port = static_cast<int>(number);
+        } else if (strcmp(option, "--devices") == 0) {
+            valid = parseUnsigned(value, 1, 1000000, config.devices);
+        } else if (strcmp(option, "--threads") == 0) {
+            valid = parseUnsigned(value, 1, 1024, config.threads);
+        } else if (strcmp(option, "--duration-s") == 0) {
+            valid = parseUnsigned(value, 1, 86400, duration_s);
+        } else if (strcmp(option, "--rate") == 0) {
+            char* end = nullptr;
+            config.rate_hz = strtod(value, &end);
+            valid = end != value && *end == '\0' && config.rate_hz > 0 && config.rate_hz <= SENSOR_RATE_MAX_HZ;
+        } else if (strcmp(option, "--samples") == 0) {
+            valid = parseUnsigned(value, 1, 0xFFFF, config.samples_per_frame);
+        } else if (strcmp(option, "--ramp-ms") == 0) {
+            valid = parseUnsigned(value, 0, 3600000, config.ramp_ms);
+        } else if (strcmp(option, "--flap-every-ms") == 0) {
+            valid = parseUnsigned(value, 0, 3600000, config.flap_every_ms);
+        } else if (strcmp(option, "--flap-for-ms") == 0) {
+            valid = parseUnsigned(value, 0, 3600000, config.flap_for_ms);
+        } else if (strcmp(option, "--alert-hold-ms") == 0) {
+            valid = parseUnsigned(value, 0, 3600000, config.alert_hold_ms);
+        } else if (strcmp(option, "--compress") == 0) {
+            valid = parseUnsigned(value, 0, 1, number);
+            config.compress = number != 0;
+        } else if (strcmp(option, "--ack") == 0) {
+            valid = parseUnsigned(value, 0, 1, number);
+            config.acks = number != 0;
+        } else if (strcmp(option, "--report-s") == 0) {
+            valid = parseUnsigned(value, 1, 86400, report_s);
+        } else {
+            std::cerr << "[FLEET] Unknown option: " << option << std::endl;
+            printUsage(std::cerr);
+            return 2;
+        }
+        if (!valid) {
+            std::cerr << "[FLEET] Invalid value for " << option << ": " << value << std::endl;
+            printUsage(std::cerr);
+            return 2;
+        }
+    }
+    if (config.threads > config.devices) config.threads = config.devices;
+
+    std::signal(SIGINT, signalHandler);
+    raiseFdLimit(config.devices);
+
+    std::cout << "[FLEET] " << config.devices << " devices on " << config.threads << " threads -> "
+              << config.ip << ":" << config.port << ", " << config.rate_hz << " frames/s each, "
+              << duration_s << " s" << std::endl;
+
+    std::vector<std::unique_ptr<FleetWorker>> workers;
+    auto origin = FleetClock::now();
+    unsigned int first = 0;
+    for (unsigned int t = 0; t < config.threads; t++) {
+        unsigned int count = config.devices / config.threads + (t < config.devices % config.threads ? 1 : 0);
+        workers.push_back(std::make_unique<FleetWorker>(config, first, count));
+        if (!workers.back()->start(origin)) return 1;
+        first += count;
+    }
+
+    auto deadline = origin + seconds(duration_s);
+    auto next_report = origin + seconds(report_s);
+    FleetStats previous;
+    while (fleet_running && FleetClock::now() < deadline) {
+        std::this_thread::sleep_for(milliseconds(100));
+        if (FleetClock::now() < next_report) continue;
+
+        FleetStats stats = collect(workers);
+        std::cout << "[FLEET] t=" << duration_cast<seconds>(FleetClock::now() - origin).count()
+                  << "s online " << stats.online << "/" << config.devices
+                  << ", connects " << stats.connects << " (failed " << stats.connect_failures << ")"
+                  << ", frames/s " << (stats.frames_sent - previous.frames_sent) / report_s
+                  << ", acked " << stats.frames_acked
+                  << ", dropped " << stats.frames_dropped
+                  << ", ACK p99 " << stats.ack_rtt.percentileMs(99) << " ms" << std::endl;
+        previous = stats;
+        next_report += seconds(report_s);
+    }
+
+    for (auto& worker : workers) {
+        worker->stop();
+    }
+
+    FleetStats stats = collect(workers);
+    std::cout << "[FLEET] Connect attempts " << stats.connect_attempts << ", connected " << stats.connects
+              << ", failed " << stats.connect_failures << ", no HELLO reply " << stats.hello_timeouts
+              << ", disconnects " << stats.disconnects << ", alerts " << stats.alerts
+              << ", link flaps " << stats.link_flaps << std::endl;
+    std::cout << "[FLEET] Frames sent " << stats.frames_sent << ", acked " << stats.frames_acked
+              << ", retransmitted " << stats.frames_retransmitted << ", dropped " << stats.frames_dropped
+              << ", heartbeats " << stats.heartbeats << ", " << stats.bytes_sent << " bytes" << std::endl;
+    printLatency("TCP connect", stats.tcp_connect);
+    printLatency("Connect + HELLO", stats.handshake);
+    printLatency("Frame -> ACK", stats.ack_rtt);
+
+    return stats.connects > 0 ? 0 : 1;
+}
@@ -0,0 +1,358 @@
+/*
+ * button-led-iobench: классические сокеты против io_uring на этой машине.
+ *
+ * Клиент и приемник в одном процессе, TCP через loopback. Режимы:
+ *   stream   - кадры подряд, как очередь SmartClient (пропускная способность);
+ *   pingpong - кадр и ответ "ACK <n>\n" (задержка отправка -> подтверждение).
+ * Классический путь повторяет SmartClient: setsockopt + send + setsockopt на
+ * кадр, getsockopt + recv на прием. io_uring - UringSender/UringReceiver
+ * (uring.hpp). Печатаются кадры/с, мкс и системные вызовы на кадр, CPU
+ * клиентского потока на кадр, для pingpong - p50/p99.
+ *
+ * Параметры: --frames N  --size B  --mode stream|pingpong|both  --backend classic|uring|both
+ */
+
+#include <iostream>
+#include <cstring>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <chrono>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/resource.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include "uring.hpp"
+
+using namespace std::chrono;
+
+#define IOBENCH_TIMEOUT_MS 5000
+
+struct BenchResult {
+    uint64_t frames = 0;
+    double seconds = 0.0;
+    uint64_t syscalls = 0;
+    double cpu_us = 0.0;
+    std::vector<double> latency_us;   // только pingpong
+};
+
+// Путь клиента: отправка кадра и прием ответов
+class BenchIo {
+public:
+    virtual ~BenchIo() = default;
+    virtual bool send(const uint8_t* data, size_t size) = 0;
+    // Как UringReceiver::receive: > 0 - байт, 0 - закрыто, < 0 - -errno
+    virtual ssize_t receive(const uint8_t*& data) = 0;
+    virtual uint64_t syscalls() const = 0;
+};
+
+class ClassicIo : public BenchIo {
+public:
+    explicit ClassicIo(int fd) : fd_(fd) {}
+
+    bool send(const uint8_t* data, size_t size) override {
+        // Как SmartClient::sendDataInternal()
+        struct timeval tv = {IOBENCH_TIMEOUT_MS / 1000, 0};
+        setsockopt(fd_, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+        syscalls_++;
+
+        size_t total_sent = 0;
+        while (total_sent < size) {
+            ssize_t sent = ::send(fd_, data + total_sent, size - total_sent, MSG_NOSIGNAL);
+            syscalls_++;
+            if (sent <= 0) return false;
+            total_sent += sent;
+        }
+
+        tv.tv_sec = 10;
+        setsockopt(fd_, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+        syscalls_++;
+        return true;
+    }
+
+    ssize_t receive(const uint8_t*& data) override {
+        // Как SmartClient::receivingLoop(): проверка сокета, затем recv
+        int error = 0;
+        socklen_t len = sizeof(error);
+        getsockopt(fd_, SOL_SOCKET, SO_ERROR, &error, &len);
+        syscalls_++;
+        if (error != 0) return -error;
+
+        ssize_t received = recv(fd_, buffer_, sizeof(buffer_), 0);
+        syscalls_++;
+        if (received < 0) return -errno;
+        data = buffer_;
+        return received;
+    }
+
+    uint64_t syscalls() const override { return syscalls_; }
+
+private:
+    int fd_;
+    uint8_t buffer_[1024];
+    uint64_t syscalls_ = 0;
+};
+
+class UringIo : public BenchIo {
+public:
+    bool init(int fd) {
+        return sender_.init() && sender_.attach(fd) &&
+               receiver_.init() && receiver_.attach(fd);
+    }
+
+    bool send(const uint8_t* data, size_t size) override {
+        return sender_.send(data, size, IOBENCH_TIMEOUT_MS);
+    }
+
+    ssize_t receive(const uint8_t*& data) override {
+        return receiver_.receive(data, IOBENCH_TIMEOUT_MS);
+    }
+
+    uint64_t syscalls() const override { return sender_.syscalls() + receiver_.syscalls(); }
+
+private:
+    UringSender sender_;
+    UringReceiver receiver_;
+};
+
+static double thread_cpu_us() {
+    struct rusage usage;
+    getrusage(RUSAGE_THREAD, &usage);
+    return usage.ru_utime.tv_sec * 1e6 + usage.ru_utime.tv_usec +
+           usage.ru_stime.tv_sec * 1e6 + usage.ru_stime.tv_usec;
+}
+
+static bool readExact(int fd, uint8_t* buffer, size_t size) {
+    size_t total = 0;
+    while (total < size) {
+        ssize_t received = recv(fd, buffer + total, size - total, 0);
+        if (received <= 0) return false;
+        total += received;
+    }
+    return true;
+}
+
+static bool writeAll(int fd, const char* data, size_t size) {
+    size_t total = 0;
+    while (total < size) {
+        ssize_t sent = ::send(fd, data + total, size - total, MSG_NOSIGNAL);
+        if (sent <= 0) return false;
+        total += sent;
+    }
+    return true;
+}
+
+// Сторона сервера: читает кадры, в pingpong отвечает на каждый, в stream - на последний
+static void serve(int fd, uint64_t frames, size_t size, bool pingpong) {
+    std::vector<uint8_t> buffer(size);
+    char reply[32];
+    for (uint64_t n = 1; n <= frames; n++) {
+        if (!readExact(fd, buffer.data(), size)) break;
+        if (pingpong || n == frames) {
+            int length = snprintf(reply, sizeof(reply), "ACK %llu\n", static_cast<unsigned long long>(n));
+            if (!writeAll(fd, reply, length)) break;
+        }
+    }
+}
+
+// Ждем count строк ответа
+static bool awaitReplies(BenchIo& io, uint64_t count) {
+    while (count > 0) {
+        const uint8_t* data = nullptr;
+        ssize_t received = io.receive(data);
+        if (received <= 0) {
+            std::cerr << "[BENCH] Receive failed: " << (received == 0 ? "closed" : strerror(static_cast<int>(-received)))
+                      << std::endl;
+            return false;
+        }
+        for (ssize_t i = 0; i < received; i++) {
+            if (data[i] == '\n') count--;
+        }
+    }
+    return true;
+}
+
+static bool runOnce(int listen_fd, const struct sockaddr_in& addr, bool use_uring, bool pingpong,
+                    uint64_t frames, size_t size, BenchResult& result) {
+    int client_fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (client_fd < 0 || connect(client_fd, reinterpret_cast<const struct sockaddr*>(&addr), sizeof(addr)) < 0) {
+        std::cerr << "[BENCH] Connect failed: " << strerror(errno) << std::endl;
+        if (client_fd >= 0) close(client_fd);
+        return false;
+    }
+    int server_fd = accept(listen_fd, nullptr, nullptr);
+    if (server_fd < 0) {
+        std::cerr << "[BENCH] Accept failed: " << strerror(errno) << std::endl;
+        close(client_fd);
+        return false;
+    }
+
+    // Рабочие таймауты как у SmartClient
+    struct timeval timeout = {10, 0};
+    setsockopt(client_fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+    setsockopt(client_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    std::vector<uint8_t> frame(size);
+    for (size_t i = 0; i < size; i++) frame[i] = static_cast<uint8_t>(i * 31);
+
+    std::unique_ptr<BenchIo> io;
+    if (use_uring) {
+        auto uring = std::make_unique<UringIo>();
+        if (!uring->init(client_fd)) {
+            std::cerr << "[BENCH] io_uring init failed: " << strerror(errno) << std::endl;
+            close(client_fd);
+            close(server_fd);
+            return false;
+        }
+        io = std::move(uring);
+    } else {
+        io = std::make_unique<ClassicIo>(client_fd);
+    }
+
+    std::thread server(serve, server_fd, frames, size, pingpong);
+    if (pingpong) result.latency_us.reserve(frames);
+
+    uint64_t syscalls_start = io->syscalls();
+    double cpu_start = thread_cpu_us();
+    auto start = steady_clock::now();
+    bool ok = true;
+
+    for (uint64_t n = 0; n < frames && ok; n++) {
+        auto sent_at = steady_clock::now();
+        ok = io->send(frame.data(), frame.size());
+        if (ok && pingpong) {
+            ok = awaitReplies(*io, 1);
+            result.latency_us.push_back(duration<double, std::micro>(steady_clock::now() - sent_at).count());
+        }
+    }
+    if (ok && !pingpong) {
+        ok = awaitReplies(*io, 1);
+    }
+
+    result.seconds = duration<double>(steady_clock::now() - start).count();
+    result.cpu_us = thread_cpu_us() - cpu_start;
+    result.syscalls = io->syscalls() - syscalls_start;
+    result.frames = frames;
+
+    if (!ok) std::cerr << "[BENCH] Send failed: " << strerror(errno) << std::endl;
+
+    shutdown(client_fd, SHUT_RDWR);
+    server.join();
+    io.reset();
+    close(client_fd);
+    close(server_fd);
+    return ok;
+}
+
+static double percentile(std::vector<double>& samples, double p) {
+    if (samples.empty()) return 0.0;
+    size_t index = static_cast<size_t>(p / 100.0 * (samples.size() - 1));
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return samples[index];
+}
+
+static void printResult(const char* backend, const char* mode, size_t size, BenchResult& result) {
+    double frames = static_cast<double>(result.frames);
+    std::cout << "[BENCH] " << backend << " " << mode << " " << result.frames << " x " << size << " B: "
+              << static_cast<uint64_t>(frames / result.seconds) << " frames/s, "
+              << result.seconds * 1e6 / frames << " us/frame, "
+              << result.syscalls / frames << " syscalls/frame, CPU "
+              << result.cpu_us / frames << " us/frame";
+    if (!result.latency_us.empty()) {
+        std::cout << ", RTT p50 " << percentile(result.latency_us, 50)
+                  << " us, p99 " << percentile(result.latency_us, 99) << " us";
+    }
+    std::cout << std::endl;
+}
+
+static void printUsage(std::ostream& out) {
+    out << "Usage: button-led-iobench [--frames N] [--size B] [--mode stream|pingpong] "
+           "[--backend classic|uring]" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    uint64_t frames = 100000;
+    size_t size = 256;
+    std::string mode = "both";
+    std::string backend = "both";
+
+    for (int i = 1; i < argc; i += 2) {
+        if (strcmp(argv[i], "--help") == 0) {
+            printUsage(std::cout);
+            return 0;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "[BENCH] Missing value for " << argv[i] << std::endl;
+            printUsage(std::cerr);
+            return 2;
+        }
+        if (strcmp(argv[i], "--frames") == 0) frames = strtoull(argv[i + 1], nullptr, 10);
+        else if (strcmp(argv[i], "--size") == 0) size = strtoul(argv[i + 1], nullptr, 10);
+        else if (strcmp(argv[i], "--mode") == 0) mode = argv[i + 1];
+        else if (strcmp(argv[i], "--backend") == 0) backend = argv[i + 1];
+        else {
+            std::cerr << "[BENCH] Unknown option: " << argv[i] << std::endl;
+            printUsage(std::cerr);
+            return 2;
+        }
+    }
+    if (frames == 0 || size == 0) {
+        std::cerr << "[BENCH] --frames and --size must be positive" << std::endl;
+        printUsage(std::cerr);
+        return 2;
+    }
+    if ((mode != "both" && mode != "stream" && mode != "pingpong") ||
+        (backend != "both" && backend != "classic" && backend != "uring")) {
+        std::cerr << "[BENCH] Unknown --mode or --backend" << std::endl;
+        printUsage(std::cerr);
+        return 2;
+    }
+
+    const UringSupport& support = uringProbe();
+    std::cout << "[BENCH] io_uring: " << (support.available ? "available" : support.reason.c_str())
+              << (support.available ? (support.multishot_recv ? ", multishot recv" : ", single-shot recv") : "")
+              << std::endl;
+
+    int listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    socklen_t addr_len = sizeof(addr);
+    if (listen_fd < 0 || bind(listen_fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        listen(listen_fd, 4) < 0 || getsockname(listen_fd, reinterpret_cast<struct sockaddr*>(&addr), &addr_len) < 0) {
+        std::cerr << "[BENCH] Listen failed: " << strerror(errno) << std::endl;
+        return 1;
+    }
+
+    bool failed = false;
+    for (const char* run_mode : {"stream", "pingpong"}) {
+        if (mode != "both" && mode != run_mode) continue;
+        for (const char* run_backend : {"classic", "uring"}) {
+            if (backend != "both" && backend != run_backend) continue;
+
+            bool use_uring = strcmp(run_backend, "uring") == 0;
+            if (use_uring && !support.available) {
+                std::cout << "[BENCH] uring " << run_mode << ": skipped" << std::endl;
+                continue;
+            }
+
+            BenchResult result;
+            bool pingpong = strcmp(run_mode, "pingpong") == 0;
+            if (runOnce(listen_fd, addr, use_uring, pingpong, frames, size, result)) {
+                printResult(run_backend, run_mode, size, result);
+            } else {
+                failed = true;
+            }
+        }
+    }
+
+    close(listen_fd);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,61 @@
+/*
+ * button-led-publish: пример издателя для shm_publisher.hpp.
+ *
+ * Каждая строка stdin уходит отдельным кадром через общее соединение
+ * button-led. Если кольцо заполнено, ждем, пока button-led его разберет,
+ * но не дольше PUBLISH_RETRY_MS - потом кадр теряется (и считается один раз).
+ *
+ *   some-daemon | button-led-publish --socket /run/button-led/ingest.sock
+ *
+ * Параметры: --socket path
+ */
+
+#include <iostream>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <chrono>
+
+#include "shm_publisher.hpp"
+
+#define PUBLISH_RETRY_MS 1000
+
+int main(int argc, char* argv[]) {
+    std::string socket_path = SHM_INGEST_SOCKET_PATH;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--socket") == 0) socket_path = argv[i + 1];
+    }
+
+    ShmPublisher publisher;
+    if (!publisher.connect(socket_path)) {
+        return 1;
+    }
+
+    std::string line;
+    uint64_t published = 0;
+    while (std::getline(std::cin, line)) {
+        if (line.empty()) continue;
+        if (line.size() > SHM_RECORD_MAX_BYTES) line.resize(SHM_RECORD_MAX_BYTES);
+
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(PUBLISH_RETRY_MS);
+        bool sent = true;
+        while (!publisher.publish(reinterpret_cast<const uint8_t*>(line.data()), line.size())) {
+            if (!publisher.isConnected()) {
+                std::cerr << "[PUBLISHER] button-led closed the connection" << std::endl;
+                return 1;
+            }
+            if (std::chrono::steady_clock::now() > deadline) {
+                publisher.dropFrame();
+                sent = false;
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        if (sent) published++;
+    }
+
+    std::cout << "[PUBLISHER] Published " << published << " frames, dropped " << publisher.getDropped()
+              << " (ring full, " << publisher.getRingFull() << " retries)" << std::endl;
+    return 0;
+}
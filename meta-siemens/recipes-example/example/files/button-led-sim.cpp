@@ -0,0 +1,353 @@
+/*
+ * button-led-sim: прогон цепочки кнопка -> состояние -> LED -> сеть на x86.
+ *
+ * Железо заменено на hal_sim (SimLed, SimButton, SimLinkMonitor), сервер -
+ * локальный коллектор на loopback. Сценарий на каждой итерации:
+ *   1. пропадание линка -> ждем перехода в ALERT (led1 мигает)
+ *   2. нажатие кнопки   -> ждем переподключения (led1 горит)
+ *                       -> ждем первых байт на стороне коллектора
+ * Выводятся задержки реакции; код возврата 1, если что-то не дождались
+ * или задержка превысила --max-ms; 2 - неизвестный параметр или плохое значение.
+ *
+ * Параметры: --iterations N  --period-ms P  --max-ms M  --trace file.json
+ *            --strict-heap  (арена как на плате; при сборке с ALLOC_ACCOUNTING
+ *                            любой malloc в стабильном режиме - abort())
+ */
+
+#include <iostream>
+#include <cstring>
+#include <cstdlib>
+#include <vector>
+#include <mutex>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include "app.hpp"
+#include "hal_sim.hpp"
+#include "memory_pool.hpp"
+#include "trace.hpp"
+
+using namespace std::chrono;
+
+// Те же размеры, что RUNTIME_ARENA_BYTES / RUNTIME_POOL_BLOCK_BYTES в button-led.cpp
+#define SIM_ARENA_BYTES (4 * 1024 * 1024)
+#define SIM_POOL_BLOCK_BYTES (256 * 1024)
+
+// Коллектор на loopback: принимает HELLO и отмечает время первых данных
+class LoopbackCollector {
+public:
+    bool start() {
+        listen_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+        if (listen_fd_ < 0) return false;
+
+        int reuse = 1;
+        setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+
+        socklen_t len = sizeof(addr);
+        if (bind(listen_fd_, (struct sockaddr*)&addr, sizeof(addr)) < 0 ||
+            listen(listen_fd_, 4) < 0 ||
+            getsockname(listen_fd_, (struct sockaddr*)&addr, &len) < 0) {
+            ::close(listen_fd_);
+            return false;
+        }
+        port_ = ntohs(addr.sin_port);
+
+        running_ = true;
+        thread_ = std::thread(&LoopbackCollector::loop, this);
+        return true;
+    }
+
+    void stop() {
+        running_ = false;
+        if (thread_.joinable()) thread_.join();
+        if (listen_fd_ >= 0) ::close(listen_fd_);
+    }
+
+    int port() const { return port_; }
+
+    // Время первых данных после since (false по таймауту)
+    bool waitFirstData(SimClock::time_point since, milliseconds timeout, SimClock::time_point& when) {
+        auto deadline = SimClock::now() + timeout;
+        while (SimClock::now() < deadline) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                for (auto t : first_data_) {
+                    if (t >= since) {
+                        when = t;
+                        return true;
+                    }
+                }
+            }
+            std::this_thread::sleep_for(milliseconds(1));
+        }
+        return false;
+    }
+
+private:
+    int listen_fd_ = -1;
+    int port_ = 0;
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+    std::mutex mutex_;
+    std::vector<SimClock::time_point> first_data_;
+
+    void loop() {
+        HeapAllowedScope heap_allowed; // коллектор - не часть платы
+        int conn = -1;
+        bool got_hello = false;
+        bool got_data = false;
+        char buffer[4096];
+
+        while (running_) {
+            struct pollfd fds[2];
+            int count = 0;
+            fds[count++] = {listen_fd_, POLLIN, 0};
+            if (conn >= 0) fds[count++] = {conn, POLLIN, 0};
+
+            if (poll(fds, count, 20) <= 0) continue;
+
+            if (fds[0].revents & POLLIN) {
+                int fd = accept(listen_fd_, nullptr, nullptr);
+                if (fd >= 0) {
+                    // Клиент держит одно соединение: новое вытесняет старое
+                    if (conn >= 0) ::close(conn);
+                    conn = fd;
+                    got_hello = false;
+                    got_data = false;
+                }
+                continue;
+            }
+
+            if (count > 1 && (fds[1].revents & (POLLIN | POLLHUP | POLLERR))) {
+                ssize_t received = recv(conn, buffer, sizeof(buffer), 0);
+                auto now = SimClock::now();
+                if (received <= 0) {
+                    ::close(conn);
+                    conn = -1;
+                    continue;
+                }
+
+                size_t offset = 0;
+                if (!got_hello && strncmp(buffer, "HELLO", 5) == 0) {
+                    got_hello = true;
+                    const char reply[] = "OK codec=lz\n";
+                    send(conn, reply, sizeof(reply) - 1, MSG_NOSIGNAL);
+                    const char* eol = static_cast<const char*>(memchr(buffer, '\n', received));
+                    offset = eol ? eol - buffer + 1 : received;
+                }
+
+                if (!got_data && offset < static_cast<size_t>(received)) {
+                    got_data = true;
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    first_data_.push_back(now);
+                }
+            }
+        }
+
+        if (conn >= 0) ::close(conn);
+    }
+};
+
+struct LatencyStats {
+    const char* name;
+    std::vector<double> samples_ms;
+
+    void add(SimClock::time_point from, SimClock::time_point to) {
+        samples_ms.push_back(duration_cast<microseconds>(to - from).count() / 1000.0);
+    }
+
+    double max() const {
+        double result = 0;
+        for (double v : samples_ms) if (v > result) result = v;
+        return result;
+    }
+
+    void print() const {
+        if (samples_ms.empty()) {
+            std::cout << "[SIM] " << name << ": no samples" << std::endl;
+            return;
+        }
+        double sum = 0, min = samples_ms[0];
+        for (double v : samples_ms) {
+            sum += v;
+            if (v < min) min = v;
+        }
+        std::cout << "[SIM] " << name << ": min " << min << " ms, avg "
+                  << sum / samples_ms.size() << " ms, max " << max() << " ms ("
+                  << samples_ms.size() << " samples)" << std::endl;
+    }
+};
+
+static void printUsage(std::ostream& out) {
+    out << "Usage: button-led-sim [--iterations N] [--period-ms P] [--max-ms M] [--trace file.json] "
+           "[--strict-heap]" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    int iterations = 5;
+    int period_ms = APP_LOOP_PERIOD_MS;
+    double max_ms = 0;
+    const char* trace_path = nullptr;
+    bool strict_heap = false;
+
+    // Опечатка в параметре не должна молча отключать проверку (--max-ms): код 2
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--help") == 0) {
+            printUsage(std::cout);
+            return 0;
+        }
+        if (strcmp(argv[i], "--strict-heap") == 0) {
+            strict_heap = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "[SIM] Missing value for " << argv[i] << std::endl;
+            printUsage(std::cerr);
+            return 2;
+        }
+        const char* value = argv[++i];
+        char* end = nullptr;
+        bool valid = true;
+        if (strcmp(argv[i - 1], "--iterations") == 0) {
+            iterations = static_cast<int>(strtol(value, &end, 10));
+            valid = iterations > 0;
+        } else if (strcmp(argv[i - 1], "--period-ms") == 0) {
+            period_ms = static_cast<int>(strtol(value, &end, 10));
+            valid = period_ms > 0;
+        } else if (strcmp(argv[i - 1], "--max-ms") == 0) {
+            max_ms = strtod(value, &end);
+            valid = max_ms > 0;
+        } else if (strcmp(argv[i - 1], "--trace") == 0) {
+            trace_path = value;
+        } else {
+            std::cerr << "[SIM] Unknown option: " << argv[i - 1] << std::endl;
+            printUsage(std::cerr);
+            return 2;
+        }
+        if (!valid || (end != nullptr && (end == value || *end != '\0'))) {
+            std::cerr << "[SIM] Invalid value for " << argv[i - 1] << ": " << value << std::endl;
+            printUsage(std::cerr);
+            return 2;
+        }
+    }
+
+    if (strict_heap) {
+        if (!RuntimeMemory::accountingEnabled()) {
+            std::cerr << "[SIM] --strict-heap needs a build with -DALLOC_ACCOUNTING=ON" << std::endl;
+            return 1;
+        }
+        // Как в main() на плате: арена до создания клиента и его очередей
+        if (!RuntimeMemory::init(SIM_ARENA_BYTES, SIM_POOL_BLOCK_BYTES)) {
+            std::cerr << "[SIM] Failed to reserve runtime arena" << std::endl;
+            return 1;
+        }
+        RuntimeMemory::setStrict(true);
+    }
+    // Сценарий и статистика задержек - не рабочий цикл платы
+    HeapAllowedScope heap_allowed;
+
+    LoopbackCollector collector;
+    if (!collector.start()) {
+        std::cerr << "[SIM] Failed to start collector" << std::endl;
+        return 1;
+    }
+
+    SimLed led1("led1");
+    SimLed led2("led2");
+    SimButton button;
+    SimLinkMonitor link;
+
+    SmartClient client;
+    client.setupLed(&led1, &led2);
+    client.setupLinkMonitor(&link);
+    client.addCodec(std::make_unique<LzCodec>());
+
+    ImitationSensor sensor;
+    SensorAcquisition acquisition(sensor, 100, 1);
+    acquisition.start([&client](const std::vector<uint8_t>& frame, uint64_t trace_id) {
+        if (!client.isRunning()) return false;
+        return client.sendData(frame, trace_id);
+    });
+
+    ButtonLedApp app(led1, led2, button, client, "127.0.0.1", collector.port());
+    app.setupSensor(&acquisition);
+    app.setLoopPeriod(milliseconds(period_ms));
+
+    std::atomic<bool> running{true};
+    std::thread app_thread([&]() { app.run(running); });
+
+    const milliseconds timeout(period_ms * 10 + 2000);
+    LatencyStats link_to_alert{"link down -> ALERT", {}};
+    LatencyStats press_to_led{"button -> led1 ON", {}};
+    LatencyStats press_to_wire{"button -> bytes on wire", {}};
+    bool ok = led1.waitFor(ON, SimClock::time_point(), timeout);
+
+    for (int i = 0; ok && i < iterations; i++) {
+        SimClock::time_point when;
+
+        auto down_at = SimClock::now() + milliseconds(50);
+        // Линк пропадает на несколько периодов цикла, чтобы опрос его увидел
+        link.flap(down_at, milliseconds(period_ms * 3));
+        ok = led1.waitFor(BLINK, down_at, timeout, &when);
+        if (!ok) break;
+        link_to_alert.add(down_at, when);
+
+        // Кнопку нажимаем после восстановления линка
+        auto press_at = down_at + milliseconds(period_ms * 4);
+        button.press(press_at, milliseconds(period_ms * 2));
+
+        ok = led1.waitFor(ON, press_at, timeout, &when);
+        if (!ok) break;
+        press_to_led.add(press_at, when);
+
+        ok = collector.waitFirstData(press_at, timeout, when);
+        if (!ok) break;
+        press_to_wire.add(press_at, when);
+
+        std::this_thread::sleep_for(milliseconds(period_ms * 2));
+    }
+
+    running = false;
+    app_thread.join();
+    acquisition.stop();
+    client.stop();
+    collector.stop();
+
+    if (trace_path) {
+        Tracer::dumpChromeJson(trace_path);
+    }
+
+    std::cout << "[SIM] Loop period " << period_ms << " ms" << std::endl;
+    link_to_alert.print();
+    press_to_led.print();
+    press_to_wire.print();
+
+    if (!ok) {
+        std::cerr << "[SIM] FAILED: reaction timed out" << std::endl;
+        return 1;
+    }
+    if (strict_heap) {
+        // abort() ловит выделения сразу; здесь - что стабильный режим вообще был
+        std::cout << "[SIM] Steady state heap allocations: " << RuntimeMemory::steadyStateAllocations()
+                  << " (" << RuntimeMemory::heapAllocations() << " total)" << std::endl;
+        if (!RuntimeMemory::inSteadyState() || RuntimeMemory::steadyStateAllocations() > 0) {
+            std::cerr << "[SIM] FAILED: steady state not reached or allocated from heap" << std::endl;
+            return 1;
+        }
+    }
+    if (max_ms > 0 && (link_to_alert.max() > max_ms || press_to_led.max() > max_ms ||
+                       press_to_wire.max() > max_ms)) {
+        std::cerr << "[SIM] FAILED: latency above " << max_ms << " ms" << std::endl;
+        return 1;
+    }
+    return 0;
+}
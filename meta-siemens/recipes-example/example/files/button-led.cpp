@@ -3,10 +3,20 @@
 #include <chrono>
 #include <string>
 #include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
 #include <gpiod.hpp> // ver 2.2.1
 
 #include "button-led.hpp"
 #include "ethernet.hpp"
+#include "sensor.hpp"
+#include "shm_ingest.hpp"
+#include "memory_pool.hpp"
+#include "app.hpp"
+#include "trace.hpp"
 
 // // Конфигурация
 constexpr int LED_GPIO = 12;
@@ -16,6 +26,14 @@ constexpr int BUTTON_CHIP = 0;
 constexpr int port_num = 8080;
 const std::string ip_adr = "192.168.31.27";
 
+// По умолчанию; BUTTON_LED_SENSOR_HZ / BUTTON_LED_SENSOR_SAMPLES переопределяют
+constexpr unsigned int SENSOR_RATE_HZ = 1;
+constexpr unsigned int SENSOR_SAMPLES_PER_FRAME = 1;
+
+// Арена рабочего цикла (NO_HEAP_AFTER_INIT)
+constexpr size_t RUNTIME_ARENA_BYTES = 4 * 1024 * 1024;
+constexpr size_t RUNTIME_POOL_BLOCK_BYTES = 256 * 1024;
+
 void SysfsLedController::internal_thread(){
     while(running){
         const int sec = 1000; //ms
@@ -62,36 +80,40 @@ SysfsLedController::~SysfsLedController() {
     if(ledThread_.joinable())
         ledThread_.join();
     switchOFF();
+    if(brightness_fd_ >= 0)
+        ::close(brightness_fd_);
 }
 
 bool SysfsLedController::led_set(const char val){
-    try {
-        auto brightnessFile = std::make_unique<std::ofstream>(ledPath + "/brightness");
-        if (!brightnessFile->is_open()) {
+    if (brightness_fd_ < 0) {
+        brightness_fd_ = ::open(brightnessPath_.c_str(), O_WRONLY | O_CLOEXEC);
+        if (brightness_fd_ < 0) {
             return false;
         }
-        brightness_ = val;
-        *brightnessFile << static_cast<int>(brightness_);
-        // std::cout << ledName << " sent value " << brightness_ << std::endl;
-        return true;
-    }
-    catch(...){
-        return false;
     }
+    brightness_ = val;
+
+    char text[8];
+    int length = snprintf(text, sizeof(text), "%d", static_cast<int>(brightness_));
+    // std::cout << ledName << " sent value " << brightness_ << std::endl;
+    return pwrite(brightness_fd_, text, length, 0) == length;
 }
 
 SysfsLedController::SysfsLedController(const std::string& led_name) : ledName(led_name) {
     ledPath = "/sys/class/leds/" + ledName;
+    brightnessPath_ = ledPath + "/brightness";
+    brightness_fd_ = ::open(brightnessPath_.c_str(), O_WRONLY | O_CLOEXEC);
         
     std::cout << "LED '" << ledName << "' initialized" << std::endl;
     ledThread_ = std::thread(&SysfsLedController::internal_thread, this);
 }
 
-class SimpleButton {
+class SimpleButton : public ButtonDevice {
 private:
     std::string gpio_path_;
     int gpio_number_;
     bool active_low_;
+    mutable int value_fd_ = -1;   // держим открытым, чтение через pread
 
 public:
     SimpleButton(int gpio_number, bool active_low = true)
@@ -116,19 +138,23 @@ public:
         
         // Путь к файлу значения
         gpio_path_ = "/sys/class/gpio/gpio" + std::to_string(gpio_number_) + "/value";
+        value_fd_ = ::open(gpio_path_.c_str(), O_RDONLY | O_CLOEXEC);
         
         std::cout << "Button on GPIO" << gpio_number_ << " initialized" << std::endl;
     }
     
-    bool isPressed() const {
-        std::ifstream value_file(gpio_path_);
-        if (!value_file.is_open()) {
-            return false;
+    bool isPressed() const override {
+        if (value_fd_ < 0) {
+            value_fd_ = ::open(gpio_path_.c_str(), O_RDONLY | O_CLOEXEC);
+            if (value_fd_ < 0) {
+                return false;
+            }
         }
         
         char value;
-        value_file >> value;
-        value_file.close();
+        if (pread(value_fd_, &value, 1, 0) != 1) {
+            return false;
+        }
         
         if (active_low_) {
             return value == '0';  
@@ -138,6 +164,9 @@ public:
     }
     
     ~SimpleButton() {
+        if (value_fd_ >= 0) {
+            ::close(value_fd_);
+        }
         std::ofstream unexport_file("/sys/class/gpio/unexport");
         if (unexport_file.is_open()) {
             unexport_file << gpio_number_;
@@ -146,6 +175,20 @@ public:
     }
 };
 
+// Положительное число из переменной окружения, иначе default_value
+static unsigned int envUnsigned(const char* name, unsigned int default_value) {
+    const char* text = getenv(name);
+    if (text == nullptr) return default_value;
+    char* end = nullptr;
+    long value = strtol(text, &end, 10);
+    if (end == text || *end != '\0' || value <= 0) {
+        std::cerr << "[MAIN] Ignoring " << name << "=" << text << ", using " << default_value << std::endl;
+        return default_value;
+    }
+    // Оба параметра SensorAcquisition зажимает не выше 0xFFFF
+    return static_cast<unsigned int>(value > 0xFFFF ? 0xFFFF : value);
+}
+
 std::atomic<bool> program_running{true};
 
 void signalHandler(int signal) {
@@ -153,8 +196,20 @@ void signalHandler(int signal) {
     program_running = false;
 }
 
+// kill -USR1 <pid> -> трасса в TRACE_DEFAULT_PATH на следующей итерации цикла
+void traceDumpHandler(int) {
+    Tracer::requestDump();
+}
+
 int main(int argc, char* argv[]) {
     std::signal(SIGINT, signalHandler);
+    std::signal(SIGUSR1, traceDumpHandler);
+
+    // Вся память рабочего цикла резервируется до создания объектов
+    RuntimeMemory::init(RUNTIME_ARENA_BYTES, RUNTIME_POOL_BLOCK_BYTES);
+    if (getenv("BUTTON_LED_STRICT_HEAP")) {
+        RuntimeMemory::setStrict(true);   // abort() на malloc в стабильном режиме
+    }
 
     try {
         SysfsLedController led2("LED-IO-12");
@@ -165,110 +220,53 @@ int main(int argc, char* argv[]) {
 
         SmartClient client;
         client.setupLed(&led1, &led2);
+        // BUTTON_LED_PROTOCOL=raw - старый коллектор: без HELLO, данные как есть
+        const char* protocol = getenv("BUTTON_LED_PROTOCOL");
+        if (protocol && strcmp(protocol, "raw") == 0) {
+            client.setAckWindow(0);
+        } else {
+            client.addCodec(std::make_unique<LzCodec>());
+        }
 
-        std::string statement = "normal";  
-        int connection_attempts = 0;  
-        const int MAX_ATTEMPTS = 5;
-        
-        led2.switchOFF();
-        led1.blink(2);
-
-        while(program_running){
-            static bool eth_link_was_up = true;
-            bool eth_link_is_up = client.checkEthernetLink();
+        // BUTTON_LED_IO=uring - io_uring, если ядро позволяет
+        const char* io_backend = getenv("BUTTON_LED_IO");
+        if (io_backend && strcmp(io_backend, "uring") == 0) {
+            client.setIoBackend(IoBackend::URING);
+        }
 
-            if(eth_link_is_up == false && eth_link_was_up == true){
-                std::cerr << "[MAIN] ETH0 LINK DOWN - Cable disconnected!" << std::endl;
-                statement = "alert";
-                if (client.isRunning()) {
-                    client.stop();
-                }
-                led1.switchON();
+        // BUTTON_LED_STANDBY=ip:port - резервный сервер, любое другое значение -
+        // второе соединение к основному
+        if (const char* standby = getenv("BUTTON_LED_STANDBY")) {
+            std::string endpoint(standby);
+            size_t colon = endpoint.rfind(':');
+            if (colon != std::string::npos && colon > 0) {
+                client.setupStandby(endpoint.substr(0, colon), atoi(endpoint.c_str() + colon + 1));
+            } else {
+                client.setupStandby("", 0);
             }
-            else if (eth_link_was_up == false && eth_link_is_up == true) {
-                // Кабель подключен
-                std::cout << "[MAIN] ETH0 LINK UP - Cable connected" << std::endl;
-            }
-
-            eth_link_was_up = eth_link_is_up;
-
-            if(statement == "normal")
-            {
-                
-                if (!client.isRunning())
-                {
-                    std::cout << "Starting client..." << std::endl;// всё время заходит сюда до проверки соединения не доходит
-                    if (client.start(ip_adr, port_num)) {
-                        std::cout << "Client started successfully" << std::endl;
-                        connection_attempts = 0;
-                        led2.switchOFF();
-                        led1.switchON();
-                    } else {
-                        std::cout << "Failed to start client" << std::endl;
-                        connection_attempts++;
-
-                        
-                    }
-                }
+        }
 
-                if(!client.isConnected()){
-                    std::cerr << "[MAIN] Ethernet connection lost!" << std::endl;
-                    client.stop();
-                    connection_attempts++;
-                    if (connection_attempts >= MAX_ATTEMPTS) {
-                        std::cerr << "[MAIN] Too many failed attempts, switching to ALERT" << std::endl;
-                        statement = "alert";
-                        continue;
-                    }
-                    led1.blink(2); // rk_func_boot_connection_stop
-                    led2.switchOFF();
-                }
-                else{
-                    if(connection_attempts > 0){
-                        static auto last_reset_time = std::chrono::steady_clock::now();
-                        auto now = std::chrono::steady_clock::now();
-                        if (std::chrono::duration_cast<std::chrono::seconds>(now - last_reset_time).count() > 10) {
-                            std::cout << "[MAIN] Connection stable for 10s, resetting attempt counter" << std::endl;
-                            connection_attempts = 0;
-                            last_reset_time = now;
-                        }
-                    }
-                    static auto last_send_time = std::chrono::steady_clock::now();
-                    auto now = std::chrono::steady_clock::now();
-                    
-                    if (std::chrono::duration_cast<std::chrono::seconds>(now - last_send_time).count() >= 1) { // 1 seconds period to send
-                        std::vector<uint8_t> buf = {0x31,0x32,0x33,0x34,0x35,0x36,0x37,0x38,0x39};// imitation from sensor
-                        client.sendData(buf);
-                        last_send_time = now;
-                    }
-                }
-            }
-            else if(statement == "alert")
-            {
-                led1.blink(2); // rk_func_boot_connection_stop
-                led2.switchOFF();
-                std::cout << "[ETHERNET] Catched ETH disconnection" << std::endl;
-                if (client.isRunning()) {
-                    std::cout << "[MAIN] Stopping client in ALERT mode" << std::endl;
-                    client.stop();
-                }
-            }// alert end if
+        // Датчик работает в своем потоке по timerfd, кадры идут в очередь клиента
+        // Частота вне SENSOR_RATE_MIN_HZ..SENSOR_RATE_MAX_HZ зажимается в SensorAcquisition
+        ImitationSensor sensor;
+        SensorAcquisition acquisition(sensor, envUnsigned("BUTTON_LED_SENSOR_HZ", SENSOR_RATE_HZ),
+                                      envUnsigned("BUTTON_LED_SENSOR_SAMPLES", SENSOR_SAMPLES_PER_FRAME));
+        acquisition.start([&client](const std::vector<uint8_t>& frame, uint64_t trace_id) {
+            if (!client.isRunning()) return false;
+            return client.sendData(frame, trace_id);
+        });
 
-            if(gpio08.isPressed()) { // rk_func_sensor_alert_reaction
-                std::cout << "[MAIN] Button pressed" << std::endl;
-                if(statement == "alert") {
-                    std::cout << "[MAIN] switching to NORMAL" << std::endl;
-                    statement = "normal";
-                    connection_attempts = 0;
-                }
-            }
+        // Кадры других процессов на плате идут через то же соединение
+        ShmIngest ingest;
+        ingest.start([&client](const uint8_t* data, size_t size, uint64_t trace_id) {
+            if (!client.isRunning()) return false;
+            return client.sendData(data, size, trace_id);
+        });
 
-            std::cout   << "[STATUS] State: " << statement 
-                        << ", ETH running: " << client.isRunning()
-                        << ", ETH connected: " << client.isConnected() 
-                        << ", Attempts: " << connection_attempts << std::endl;
-            std::this_thread::sleep_for(std::chrono::milliseconds(500));
-        }
+        ButtonLedApp app(led1, led2, gpio08, client, ip_adr, port_num);
+        app.setupSensor(&acquisition);
+        app.setupIngest(&ingest);
+        app.run(program_running);
 
     //[STATUS] State: normal, ETH running: 0, ETH connected: 0, Attempts: 32 // not working
     // [STATUS] State: normal, ETH running: 1, ETH connected: 1, Attempts: 0 // working well
@@ -5,16 +5,20 @@
 #include <string>
 #include <thread>
 
+#include "hal.hpp"
+
 #define STANDARD_LED_FREQ_BLINK_HZ 2
 
 enum led_statement_e{
         BLINK, ON, OFF
     };
 
-class SysfsLedController {
+class SysfsLedController : public LedDevice {
 private:
     std::string ledPath;
     std::string ledName;
+    std::string brightnessPath_;
+    int brightness_fd_ = -1;   // открыт один раз, запись без выделения памяти
     std::atomic<bool> blinking{true};
     std::atomic<bool> running{true};
     std::thread ledThread_;
@@ -40,9 +44,9 @@ public:
     void ledLoop();
 
     bool led_set(const char val);
-    void switchON();
-    void switchOFF();
-    void blink(int hz);
+    void switchON() override;
+    void switchOFF() override;
+    void blink(int hz) override;
     void stop_thread(bool isContinue);
 };
 
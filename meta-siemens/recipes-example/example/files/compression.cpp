@@ -0,0 +1,140 @@
+#include <algorithm>
+#include <cstring>
+
+#include "compression.hpp"
+
+static constexpr size_t MIN_MATCH = 4;
+static constexpr size_t MAX_OFFSET = 0xFFFF;
+
+static uint32_t read32(const uint8_t* p) {
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static void write_length(std::vector<uint8_t>& out, size_t length) {
+    while (length >= 255) {
+        out.push_back(255);
+        length -= 255;
+    }
+    out.push_back(static_cast<uint8_t>(length));
+}
+
+static void emit_sequence(std::vector<uint8_t>& out, const uint8_t* literals, size_t literal_len,
+                          size_t offset, size_t match_len) {
+    const size_t lit_nibble = literal_len < 15 ? literal_len : 15;
+    const size_t match_code = match_len ? match_len - MIN_MATCH : 0;
+    const size_t match_nibble = match_code < 15 ? match_code : 15;
+
+    out.push_back(static_cast<uint8_t>((lit_nibble << 4) | match_nibble));
+    if (lit_nibble == 15) write_length(out, literal_len - 15);
+    out.insert(out.end(), literals, literals + literal_len);
+
+    if (match_len == 0) return;  // последняя последовательность
+
+    out.push_back(static_cast<uint8_t>(offset));
+    out.push_back(static_cast<uint8_t>(offset >> 8));
+    if (match_nibble == 15) write_length(out, match_code - 15);
+}
+
+static bool read_length(const uint8_t*& ip, const uint8_t* end, size_t& length) {
+    uint8_t byte;
+    do {
+        if (ip >= end) return false;
+        byte = *ip++;
+        length += byte;
+    } while (byte == 255);
+    return true;
+}
+
+bool NullCodec::compress(const uint8_t* in, size_t size, std::vector<uint8_t>& out) {
+    out.insert(out.end(), in, in + size);
+    return true;
+}
+
+bool NullCodec::decompress(const uint8_t* in, size_t size, size_t raw_size, std::vector<uint8_t>& out) {
+    if (size != raw_size) return false;
+    out.insert(out.end(), in, in + size);
+    return true;
+}
+
+LzCodec::LzCodec() : table_(1u << HASH_BITS) {}
+
+bool LzCodec::compress(const uint8_t* in, size_t size, std::vector<uint8_t>& out) {
+    // Ячеек не больше, чем позиций во входе: остальные не трогаем и не читаем
+    unsigned int hash_bits = MIN_HASH_BITS;
+    while (hash_bits < HASH_BITS && (static_cast<size_t>(1) << hash_bits) < size) {
+        hash_bits++;
+    }
+    std::fill(table_.begin(), table_.begin() + (1u << hash_bits), 0);
+
+    size_t ip = 0;
+    size_t anchor = 0;
+
+    while (ip + MIN_MATCH <= size) {
+        const uint32_t sequence = read32(in + ip);
+        const uint32_t hash = (sequence * 2654435761u) >> (32 - hash_bits);
+
+        // В таблице хранится позиция + 1, 0 - пустая ячейка
+        const size_t candidate = table_[hash];
+        table_[hash] = static_cast<uint32_t>(ip + 1);
+
+        if (candidate == 0 || ip - (candidate - 1) > MAX_OFFSET ||
+            read32(in + candidate - 1) != sequence) {
+            ip++;
+            continue;
+        }
+
+        const size_t ref = candidate - 1;
+        size_t match_len = MIN_MATCH;
+        while (ip + match_len < size && in[ref + match_len] == in[ip + match_len]) {
+            match_len++;
+        }
+
+        emit_sequence(out, in + anchor, ip - anchor, ip - ref, match_len);
+        ip += match_len;
+        anchor = ip;
+    }
+
+    emit_sequence(out, in + anchor, size - anchor, 0, 0);
+    return true;
+}
+
+bool LzCodec::decompress(const uint8_t* in, size_t size, size_t raw_size, std::vector<uint8_t>& out) {
+    const size_t base = out.size();
+    const uint8_t* ip = in;
+    const uint8_t* end = in + size;
+
+    while (ip < end) {
+        const uint8_t token = *ip++;
+
+        size_t literal_len = token >> 4;
+        if (literal_len == 15 && !read_length(ip, end, literal_len)) return false;
+        if (static_cast<size_t>(end - ip) < literal_len) return false;
+        if (out.size() - base + literal_len > raw_size) return false;
+        out.insert(out.end(), ip, ip + literal_len);
+        ip += literal_len;
+
+        if (ip == end) break;
+
+        if (end - ip < 2) return false;
+        const size_t offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+
+        size_t match_len = token & 0x0F;
+        if (match_len == 15 && !read_length(ip, end, match_len)) return false;
+        match_len += MIN_MATCH;
+
+        const size_t produced = out.size() - base;
+        if (offset == 0 || offset > produced) return false;
+        if (produced + match_len > raw_size) return false;
+
+        // Побайтно: совпадение может перекрывать само себя
+        size_t from = out.size() - offset;
+        for (size_t i = 0; i < match_len; i++) {
+            out.push_back(out[from + i]);
+        }
+    }
+
+    return out.size() - base == raw_size;
+}
@@ -0,0 +1,77 @@
+#ifndef COMPRESSION_MODULE_HPP
+#define COMPRESSION_MODULE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+enum codec_id_e : uint8_t {
+    CODEC_NONE = 0,
+    CODEC_LZ = 1
+};
+
+// Интерфейс кодека полезной нагрузки
+class PayloadCodec {
+public:
+    virtual ~PayloadCodec() = default;
+
+    virtual codec_id_e id() const = 0;
+    virtual const char* name() const = 0;
+
+    // Результат дописывается в конец out
+    virtual bool compress(const uint8_t* in, size_t size, std::vector<uint8_t>& out) = 0;
+    virtual bool decompress(const uint8_t* in, size_t size, size_t raw_size, std::vector<uint8_t>& out) = 0;
+};
+
+class NullCodec : public PayloadCodec {
+public:
+    codec_id_e id() const override { return CODEC_NONE; }
+    const char* name() const override { return "none"; }
+
+    bool compress(const uint8_t* in, size_t size, std::vector<uint8_t>& out) override;
+    bool decompress(const uint8_t* in, size_t size, size_t raw_size, std::vector<uint8_t>& out) override;
+};
+
+/*
+ * Быстрый LZ77 кодек (формат последовательностей как в LZ4):
+ *   token: старшие 4 бита - длина литералов, младшие - длина совпадения - 4
+ *   [доп. байты длины литералов] литералы [u16 смещение] [доп. байты длины совпадения]
+ * Последняя последовательность содержит только литералы.
+ * Хэш-таблица выделяется один раз, на сжатие память не выделяется.
+ * Для короткого входа используется и очищается только начало таблицы
+ * (кадр датчика в пару десятков байт не платит за 16 КиБ memset).
+ */
+// Наихудший размер выхода LzCodec (несжимаемые данные: одни литералы)
+#define LZ_COMPRESS_BOUND(size) ((size) + (size) / 255 + 16)
+
+class LzCodec : public PayloadCodec {
+public:
+    LzCodec();
+
+    codec_id_e id() const override { return CODEC_LZ; }
+    const char* name() const override { return "lz"; }
+
+    bool compress(const uint8_t* in, size_t size, std::vector<uint8_t>& out) override;
+    bool decompress(const uint8_t* in, size_t size, size_t raw_size, std::vector<uint8_t>& out) override;
+
+private:
+    static constexpr unsigned int HASH_BITS = 12;
+    static constexpr unsigned int MIN_HASH_BITS = 6;
+    std::vector<uint32_t> table_;
+};
+
+struct CompressionStats {
+    uint64_t batches = 0;
+    uint64_t raw_bytes = 0;
+    uint64_t wire_bytes = 0;
+    uint64_t cpu_ns = 0;
+
+    double last_ratio = 1.0;
+    uint64_t last_cpu_ns = 0;
+
+    double ratio() const {
+        return wire_bytes ? static_cast<double>(raw_bytes) / wire_bytes : 1.0;
+    }
+};
+
+#endif
@@ -1,5 +1,6 @@
 #include <iostream>
 #include <memory>
+#include <new>
 #include <vector>
 #include <cstring>
 #include <unistd.h>
@@ -10,22 +11,37 @@
 #include <chrono>
 #include <sys/ioctl.h>
 #include <net/if.h>
+#include <poll.h>
+#include <ctime>
 
 #include "ethernet.hpp"
+#include "protocol.hpp"
+#include "trace.hpp"
 
-static void socket_deleter(int* fd) {
-    if (fd && *fd >= 0) {
-        ::close(*fd);
-        std::cout << "[ETHERNET] Socket closed: " << *fd << std::endl;
-    }
-    delete fd;
-}
+#include "memory_pool.hpp"
 
-SmartSocket::SmartSocket() 
-    : socket_fd_(new int(-1), socket_deleter) {}
+SmartSocket::SmartSocket() {}
 
 SmartSocket::SmartSocket(int fd) 
-    : socket_fd_(new int(fd), socket_deleter) {}
+    : socket_fd_(fd) {}
+
+SmartSocket::~SmartSocket() {
+    close();
+}
+
+SmartSocket::SmartSocket(SmartSocket&& other) noexcept
+    : socket_fd_(other.socket_fd_) {
+    other.socket_fd_ = -1;
+}
+
+SmartSocket& SmartSocket::operator=(SmartSocket&& other) noexcept {
+    if (this != &other) {
+        close();
+        socket_fd_ = other.socket_fd_;
+        other.socket_fd_ = -1;
+    }
+    return *this;
+}
 
 bool SmartSocket::create() {
     int fd = ::socket(AF_INET, SOCK_STREAM, 0);
@@ -34,45 +50,98 @@ bool SmartSocket::create() {
                   << strerror(errno) << std::endl;
         return false;
     }
-    socket_fd_.reset(new int(fd));
+    reset(fd);
     return true;
 }
 
 int SmartSocket::get() const {
-    return socket_fd_ ? *socket_fd_ : -1;
+    return socket_fd_;
 }
 
 void SmartSocket::reset(int fd) {
-    socket_fd_.reset(new int(fd));
+    close();
+    socket_fd_ = fd;
 }
 
 bool SmartSocket::isValid() const {
-    return socket_fd_ && *socket_fd_ >= 0;
+    return socket_fd_ >= 0;
 }
 
 void SmartSocket::close() {
-    if (socket_fd_ && *socket_fd_ >= 0) {
-        ::close(*socket_fd_);
-        socket_fd_.reset(new int(-1));
+    if (socket_fd_ >= 0) {
+        ::close(socket_fd_);
+        std::cout << "[ETHERNET] Socket closed: " << socket_fd_ << std::endl;
+        socket_fd_ = -1;
     }
 }
 
-void SmartClient::setupLed(SysfsLedController* led1, SysfsLedController* led2) {
+void SmartClient::setupLed(LedDevice* led1, LedDevice* led2) {
     led1_ = led1;
     led2_ = led2;
 }
 
-SmartClient::SmartClient() {
+void SmartClient::setupLinkMonitor(LinkMonitor* link) {
+    link_ = link ? link : &default_link_;
+}
+
+void SmartClient::addCodec(std::unique_ptr<PayloadCodec> codec) {
+    if (codec) {
+        codecs_.push_back(std::move(codec));
+    }
+}
+
+const char* SmartClient::getCodecName() const {
+    // Поток отправки меняет протокол при failover - читаем под тем же мьютексом
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    if (!framed_) return "raw";
+    return active_codec_ ? active_codec_->name() : "none";
+}
+
+CompressionStats SmartClient::getCompressionStats() const {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    return compression_stats_;
+}
+
+void SmartClient::setAckWindow(size_t frames) {
+    window_ = frames;
+}
+
+DeliveryStats SmartClient::getDeliveryStats() const {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    DeliveryStats stats = delivery_stats_;
+    stats.dropped = dropped_frames_;
+    return stats;
+}
+
+void SmartClient::setIoBackend(IoBackend backend) {
+    io_backend_ = backend;
+}
+
+const char* SmartClient::getIoBackendName() const {
+    return uring_active_ ? "io_uring" : "classic";
+}
+
+static uint64_t monotonic_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + ts.tv_nsec;
+}
+
+SmartClient::SmartClient()
+    : send_queue_(RuntimeMemory::resource()), inflight_(RuntimeMemory::resource()) {
     signal(SIGPIPE, SIG_IGN);
     socket_ = std::make_unique<SmartSocket>();
+    // LZ сначала пишет сжатый вариант и только потом откатывается на raw:
+    // резерв под худший случай, чтобы буфер не рос в рабочем цикле
+    wire_buf_.reserve(PROTOCOL_FRAME_HEADER_SIZE + LZ_COMPRESS_BOUND(SMART_CLIENT_MAX_FRAME_BYTES));
 }
 
 SmartClient::~SmartClient() {
     stop();
 }
 
-bool SmartClient::checkConnection() {
-    if (!socket_->isValid()) {
+bool SmartClient::checkConnection(int fd) {
+    if (fd < 0) {
         return false;
     }
     
@@ -80,7 +149,7 @@ bool SmartClient::checkConnection() {
     int error = 0;
     socklen_t len = sizeof(error);
     
-    if (getsockopt(socket_->get(), SOL_SOCKET, SO_ERROR, &error, &len) < 0) {
+    if (getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &len) < 0) {
         return false;
     }
     
@@ -92,22 +161,77 @@ void SmartClient::cleanup() {
         shutdown(socket_->get(), SHUT_RDWR);
         socket_->close();
     }
-    socket_.reset(new SmartSocket());
     connected_ = false;
     running_ = false;
 }
 
 bool SmartClient::start(const std::string& ip, int port) {
     // Если уже работает - останавливаем
-    if (running_) {
+    if (running_ || sender_thread_.joinable() || receiver_thread_.joinable()) {
         stop();
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
     }
     
     std::cout << "[ETHERNET] Starting client..." << std::endl;
     
+    if (!openConnection(ip, port, *socket_, SMART_CLIENT_SOCKET_TIMEOUT_S * 1000)) {
+        cleanup();
+        return false;
+    }
+    
+    // Договариваемся о кодеке и подтверждениях (до запуска потоков)
+    NegotiatedProtocol protocol;
+    if (!negotiateProtocol(socket_->get(), ip, port, protocol)) {
+        cleanup();
+        return false;
+    }
+    applyProtocol(protocol);
+    restoreInflight();
+
+    // Проверка ядра один раз на процесс; дальше кольца создают сами потоки
+    uring_active_ = false;
+    if (io_backend_ == IoBackend::URING) {
+        const UringSupport& support = uringProbe();
+        if (support.available) {
+            uring_active_ = true;
+            std::cout << "[ETHERNET] Using io_uring (" << (support.multishot_recv ? "multishot" : "single-shot")
+                      << " recv)" << std::endl;
+        } else {
+            std::cout << "[ETHERNET] io_uring unavailable (" << support.reason
+                      << "), using classic sockets" << std::endl;
+        }
+    }
+
+    connected_ = true;
+    running_ = true;
+    
+    // Сбрасываем счетчик
+    message_counter_ = 0;
+    
+    // Запускаем потоки
+    sender_thread_ = std::thread(&SmartClient::sendingLoop, this);
+    receiver_thread_ = std::thread(&SmartClient::receivingLoop, this);
+
+    if (standby_enabled_) {
+        {
+            std::lock_guard<std::mutex> lock(standby_mutex_);
+            active_ip_ = ip;
+            active_port_ = port;
+            if (standby_ip_.empty()) {
+                standby_ip_ = ip;
+                standby_port_ = port;
+            }
+        }
+        standby_thread_ = std::thread(&SmartClient::standbyLoop, this);
+    }
+    
+    std::cout << "[ETHERNET] Client started successfully!" << std::endl;
+    return true;
+}
+
+bool SmartClient::openConnection(const std::string& ip, int port, SmartSocket& socket, int connect_timeout_ms) {
     // Создаем сокет
-    if (!socket_->create()) {
+    if (!socket.create()) {
         std::cerr << "[ETHERNET] Failed to create socket" << std::endl;
         return false;
     }
@@ -120,108 +244,650 @@ bool SmartClient::start(const std::string& ip, int port) {
     
     if (inet_pton(AF_INET, ip.c_str(), &server_addr.sin_addr) <= 0) {
         std::cerr << "[ETHERNET] Invalid IP address: " << ip << std::endl;
-        cleanup();
+        socket.close();
         return false;
     }
     
-    // Устанавливаем таймауты (10 секунд)
+    // Таймаут connect() задается через SO_SNDTIMEO
     struct timeval timeout;
-    timeout.tv_sec = 10;
-    timeout.tv_usec = 0;
-    
-    setsockopt(socket_->get(), SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
-    setsockopt(socket_->get(), SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    timeout.tv_sec = connect_timeout_ms / 1000;
+    timeout.tv_usec = (connect_timeout_ms % 1000) * 1000;
+    setsockopt(socket.get(), SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
     
     // Включаем keepalive
     int keepalive = 1;
-    setsockopt(socket_->get(), SOL_SOCKET, SO_KEEPALIVE, &keepalive, sizeof(keepalive));
+    setsockopt(socket.get(), SOL_SOCKET, SO_KEEPALIVE, &keepalive, sizeof(keepalive));
     
     // Подключаемся
     std::cout << "[ETHERNET] Connecting to " << ip << ":" << port << "..." << std::endl;
     
-    if (::connect(socket_->get(), (struct sockaddr*)&server_addr, sizeof(server_addr)) < 0) {
+    if (::connect(socket.get(), (struct sockaddr*)&server_addr, sizeof(server_addr)) < 0) {
         std::cerr << "[ETHERNET] Connection failed: " << strerror(errno) << std::endl;
-        cleanup();
+        socket.close();
         return false;
     }
-    
-    connected_ = true;
-    running_ = true;
-    
-    // Сбрасываем счетчик
-    message_counter_ = 0;
-    
-    // Запускаем потоки
-    sender_thread_ = std::thread(&SmartClient::sendingLoop, this);
-    receiver_thread_ = std::thread(&SmartClient::receivingLoop, this);
-    
-    std::cout << "[ETHERNET] Client started successfully!" << std::endl;
+
+    // Рабочие таймауты (10 секунд)
+    timeout.tv_sec = SMART_CLIENT_SOCKET_TIMEOUT_S;
+    timeout.tv_usec = 0;
+    setsockopt(socket.get(), SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+    setsockopt(socket.get(), SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    return true;
+}
+
+void SmartClient::applyProtocol(const NegotiatedProtocol& protocol) {
+    // Сам поток отправки читает эти поля без блокировки: пишет их только он
+    // (или start(), пока потоков нет); мьютекс - для getCodecName() из main
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    framed_ = protocol.framed;
+    active_codec_ = protocol.codec;
+    acks_enabled_ = protocol.acks;
+}
+
+void SmartClient::restoreInflight() {
+    if (inflight_.empty()) return;
+
+    if (acks_enabled_) {
+        // Повторяем с теми же номерами - сервер отбросит дубликаты
+        resend_index_ = 0;
+        std::cout << "[ETHERNET] Retransmitting " << inflight_.size() << " unacked frames" << std::endl;
+        return;
+    }
+
+    // Сервер без ACK: кадры уходят обычной очередью, без номеров
+    std::unique_lock<std::mutex> lock(queue_mutex_);
+    while (!inflight_.empty()) {
+        send_queue_.push_front(std::move(inflight_.back()));
+        inflight_.pop_back();
+    }
+    resend_index_ = 0;
+    std::cout << "[ETHERNET] Server has no ACK support, requeued "
+              << send_queue_.size() << " frames" << std::endl;
+    lock.unlock();
+
+    std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+    delivery_stats_.in_flight = 0;
+}
+
+bool SmartClient::negotiateProtocol(int fd, const std::string& ip, int port, NegotiatedProtocol& result) {
+    result = NegotiatedProtocol();
+    if (codecs_.empty() && window_ == 0) {
+        return true;
+    }
+
+    // Старый сервер принимает HELLO как данные и молчит: ждать ответа и
+    // слать ему HELLO на каждом переподключении незачем
+    const std::string endpoint = ip + ":" + std::to_string(port);
+    {
+        std::lock_guard<std::mutex> lock(legacy_mutex_);
+        for (const auto& legacy : legacy_endpoints_) {
+            if (legacy == endpoint) {
+                std::cout << "[ETHERNET] " << endpoint << " did not answer HELLO before, sending raw payloads"
+                          << std::endl;
+                return true;
+            }
+        }
+    }
+
+    std::string names;
+    for (const auto& codec : codecs_) {
+        names += codec->name();
+        names += ",";
+    }
+    names += "none";
+
+    std::string hello = buildHello(names, window_ > 0);
+    if (send(fd, hello.c_str(), hello.length(), MSG_NOSIGNAL) < 0) {
+        std::cerr << "[ETHERNET] Failed to send HELLO: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    struct pollfd pfd;
+    pfd.fd = fd;
+    pfd.events = POLLIN;
+    int ready = poll(&pfd, 1, PROTOCOL_HELLO_TIMEOUT_MS);
+    if (ready < 0) {
+        std::cerr << "[ETHERNET] Failed to wait for HELLO reply: " << strerror(errno) << std::endl;
+        return false;
+    }
+    if (ready == 0) {
+        std::cout << "[ETHERNET] No HELLO reply, sending raw payloads" << std::endl;
+        markLegacyEndpoint(endpoint);
+        return true;
+    }
+
+    // Закрытое соединение - не старый сервер, а мертвый: подключение не удалось
+    char reply[128];
+    ssize_t received = recv(fd, reply, sizeof(reply) - 1, 0);
+    if (received <= 0) {
+        std::cerr << "[ETHERNET] Connection closed during HELLO"
+                  << (received < 0 ? std::string(": ") + strerror(errno) : std::string()) << std::endl;
+        return false;
+    }
+    reply[received] = '\0';
+
+    std::string codec_name;
+    bool ack = false;
+    if (!parseHelloReply(reply, codec_name, ack)) {
+        std::cout << "[ETHERNET] Server did not accept HELLO, sending raw payloads" << std::endl;
+        markLegacyEndpoint(endpoint);
+        return true;
+    }
+
+    for (const auto& codec : codecs_) {
+        if (codec_name == codec->name()) {
+            result.codec = codec.get();
+        }
+    }
+    if (result.codec == nullptr && codec_name != "none") {
+        // Сервер ждет кадры в кодеке, которого у нас нет: договориться не вышло
+        std::cerr << "[ETHERNET] Server chose unknown codec '" << codec_name << "'" << std::endl;
+        return false;
+    }
+
+    result.framed = true;
+    result.acks = ack && window_ > 0;
+    std::cout << "[ETHERNET] Negotiated codec: " << codec_name
+              << ", acks: " << (result.acks ? "on" : "off") << std::endl;
+    return true;
+}
+
+void SmartClient::markLegacyEndpoint(const std::string& endpoint) {
+    std::lock_guard<std::mutex> lock(legacy_mutex_);
+    for (const auto& legacy : legacy_endpoints_) {
+        if (legacy == endpoint) return;
+    }
+    legacy_endpoints_.push_back(endpoint);
+}
+
+void SmartClient::setupStandby(const std::string& ip, int port) {
+    std::lock_guard<std::mutex> lock(standby_mutex_);
+    standby_enabled_ = true;
+    // Пустой ip - второе соединение к тому же серверу
+    standby_ip_ = ip;
+    standby_port_ = port;
+}
+
+bool SmartClient::failover() {
+    if (!standby_enabled_) return false;
+
+    uint64_t started_ns = monotonic_ns();
+    std::unique_ptr<SmartSocket> next;
+    NegotiatedProtocol protocol;
+    std::string ip;
+    int port = 0;
+    {
+        std::lock_guard<std::mutex> lock(standby_mutex_);
+        if (!standby_ready_) {
+            std::cerr << "[ETHERNET] Standby connection not ready, failover impossible" << std::endl;
+            return false;
+        }
+        next = std::move(standby_socket_);
+        protocol = standby_protocol_;
+        standby_ready_ = false;
+
+        // Резерв теперь смотрит туда, где был основной
+        std::swap(active_ip_, standby_ip_);
+        std::swap(active_port_, standby_port_);
+        ip = active_ip_;
+        port = active_port_;
+    }
+    standby_cv_.notify_all();
+
+    {
+        std::unique_lock<std::mutex> lock(conn_mutex_);
+        // Второй failover подряд: receiver может еще сидеть в recv() на сокете
+        // прошлого переключения. Закрыть его здесь нельзя - номер дескриптора
+        // тут же займет новый резерв, и receiver прочтет чужие строки.
+        // Ждем, пока receiver сам закроет его и перейдет на текущий сокет
+        conn_cv_.wait(lock, [this] {
+            return receiver_generation_ == generation_ || !running_ || !connected_;
+        });
+        // Будим receiver из recv() на старом сокете; закроет его он сам
+        shutdown(socket_->get(), SHUT_RDWR);
+        retired_socket_ = std::move(socket_);
+        socket_ = std::move(next);
+        generation_++;
+    }
+    conn_cv_.notify_all();
+
+    applyProtocol(protocol);
+    restoreInflight();
+
+    double elapsed_us = (monotonic_ns() - started_ns) / 1e3;
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        delivery_stats_.failovers++;
+        delivery_stats_.last_failover_us = elapsed_us;
+    }
+    std::cout << "[ETHERNET] Failover to standby " << ip << ":" << port
+              << " in " << static_cast<uint64_t>(elapsed_us) << " us" << std::endl;
+    return true;
+}
+
+bool SmartClient::receiverLost(uint64_t generation) {
+    if (!standby_enabled_) {
+        connected_ = false;
+        running_ = false;
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(conn_mutex_);
+        // Сокет уже сменили - ошибка относилась к старому
+        if (generation_ != generation) return true;
+    }
+
+    // Переключает поток отправки: ему принадлежат очередь и inflight_
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        connection_failed_ = true;
+        failed_generation_ = generation;
+    }
+    queue_cv_.notify_all();
+
+    std::unique_lock<std::mutex> lock(conn_mutex_);
+    conn_cv_.wait(lock, [this, generation] {
+        return generation_ != generation || !running_ || !connected_;
+    });
+    return running_ && connected_;
+}
+
+bool SmartClient::checkStandbyLocked() {
+    int fd = standby_socket_->get();
+
+    struct pollfd pfd;
+    pfd.fd = fd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    if (poll(&pfd, 1, 0) < 0) return false;
+    if (pfd.revents & (POLLERR | POLLHUP | POLLNVAL)) return false;
+
+    if (pfd.revents & POLLIN) {
+        // До переключения сервер шлет сюда разве что ответы на PING
+        char buffer[256];
+        ssize_t received = recv(fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+        if (received == 0) return false;
+        if (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK) return false;
+    }
+
+    // Heartbeat держит соединение живым на сервере и проверяет путь отправки
+    char ping[32];
+    // Свой счетчик: message_counter_ - сообщения основного соединения для приложения
+    int length = snprintf(ping, sizeof(ping), "PING#%u\n", ++standby_pings_);
+    ssize_t sent = send(fd, ping, length, MSG_NOSIGNAL | MSG_DONTWAIT);
+    if (sent < 0 && errno != EAGAIN && errno != EWOULDBLOCK) return false;
     return true;
 }
 
+void SmartClient::standbyLoop() {
+    std::cout << "[ETHERNET] Standby thread started" << std::endl;
+    Tracer::setThreadName("eth-standby");
+
+    while (running_) {
+        bool ready = false;
+        std::string ip;
+        int port = 0;
+        {
+            std::lock_guard<std::mutex> lock(standby_mutex_);
+            ready = standby_ready_;
+            ip = standby_ip_;
+            port = standby_port_;
+        }
+
+        if (!ready) {
+            HeapAllowedScope heap_allowed; // подключение - не стабильный режим
+            auto socket = std::make_unique<SmartSocket>();
+            NegotiatedProtocol protocol;
+            // Без HELLO резерв не готов: сокет закрывается, повтор через SMART_CLIENT_STANDBY_RETRY_MS
+            if (openConnection(ip, port, *socket, SMART_CLIENT_STANDBY_CONNECT_TIMEOUT_MS) &&
+                negotiateProtocol(socket->get(), ip, port, protocol)) {
+                std::lock_guard<std::mutex> lock(standby_mutex_);
+                // За время подключения failover мог поменять адреса местами
+                if (ip == standby_ip_ && port == standby_port_) {
+                    standby_socket_ = std::move(socket);
+                    standby_protocol_ = protocol;
+                    standby_ready_ = true;
+                    std::cout << "[ETHERNET] Standby connection ready (" << ip << ":" << port << ")" << std::endl;
+                }
+            }
+        }
+
+        std::unique_lock<std::mutex> lock(standby_mutex_);
+        if (standby_ready_ && !checkStandbyLocked()) {
+            std::cerr << "[ETHERNET] Standby connection lost" << std::endl;
+            standby_socket_.reset();
+            standby_ready_ = false;
+        }
+
+        int wait_ms = standby_ready_ ? SMART_CLIENT_HEARTBEAT_MS : SMART_CLIENT_STANDBY_RETRY_MS;
+        bool was_ready = standby_ready_;
+        standby_cv_.wait_for(lock, std::chrono::milliseconds(wait_ms),
+            [this, was_ready] { return !running_ || standby_ready_ != was_ready; });
+    }
+
+    std::cout << "[ETHERNET] Standby thread stopped" << std::endl;
+}
+
+static uint64_t thread_cpu_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + ts.tv_nsec;
+}
+
+bool SmartClient::sendFrame(const uint8_t* data, size_t size, uint32_t seq, uint16_t flags) {
+    TRACE_SCOPE("frame_encode", 0, TRACE_FLOW_NONE);
+    if (!framed_) {
+        return sendDataInternal(data, size);
+    }
+
+    FrameHeader header;
+    uint64_t cpu_start = thread_cpu_ns();
+    buildFrame(active_codec_, data, size, seq, flags, wire_buf_, header);
+    uint64_t cpu_ns = active_codec_ ? thread_cpu_ns() - cpu_start : 0;
+
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        compression_stats_.batches++;
+        compression_stats_.raw_bytes += header.raw_size;
+        compression_stats_.wire_bytes += header.wire_size;
+        compression_stats_.cpu_ns += cpu_ns;
+        compression_stats_.last_ratio = header.wire_size ?
+            static_cast<double>(header.raw_size) / header.wire_size : 1.0;
+        compression_stats_.last_cpu_ns = cpu_ns;
+    }
+
+    return sendDataInternal(wire_buf_.data(), wire_buf_.size());
+}
+
+bool SmartClient::hasWorkLocked() const {
+    if (connection_failed_ || ack_pending_ || resend_index_ < inflight_.size()) return true;
+    if (send_queue_.empty()) return false;
+    return !acks_enabled_ || inflight_.size() < window_;
+}
+
+void updateRttEstimate(DeliveryStats& stats, double sample_ms) {
+    // RFC 6298, 2.2-2.4
+    if (stats.srtt_ms == 0.0) {
+        stats.srtt_ms = sample_ms;
+        stats.rttvar_ms = sample_ms / 2;
+    } else {
+        double delta = stats.srtt_ms > sample_ms ? stats.srtt_ms - sample_ms : sample_ms - stats.srtt_ms;
+        stats.rttvar_ms = 0.75 * stats.rttvar_ms + 0.25 * delta;
+        stats.srtt_ms = 0.875 * stats.srtt_ms + 0.125 * sample_ms;
+    }
+    stats.rto_ms = stats.srtt_ms + 4 * stats.rttvar_ms;
+    if (stats.rto_ms < SMART_CLIENT_RTO_MIN_MS) stats.rto_ms = SMART_CLIENT_RTO_MIN_MS;
+}
+
+double ackTimeoutMs(const DeliveryStats& stats) {
+    double timeout_ms = 4 * stats.rto_ms;
+    return timeout_ms < SMART_CLIENT_ACK_TIMEOUT_MIN_MS ? SMART_CLIENT_ACK_TIMEOUT_MIN_MS : timeout_ms;
+}
+
+void SmartClient::updateRtt(double sample_ms) {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    updateRttEstimate(delivery_stats_, sample_ms);
+}
+
+void SmartClient::releaseAcked(uint32_t acked, uint64_t received_ns) {
+    // ACK за последним отправленным номером - ошибка сервера: окно не трогаем,
+    // иначе неотправленные и потерянные кадры пропали бы без повтора
+    if (!seqLessOrEqual(acked, next_seq_ - 1)) {
+        std::cerr << "[ETHERNET] Ignoring ACK " << acked << " beyond last sent frame #"
+                  << next_seq_ - 1 << std::endl;
+        return;
+    }
+
+    size_t released = 0;
+    while (!inflight_.empty() && seqLessOrEqual(inflight_.front().seq, acked)) {
+        QueuedFrame& frame = inflight_.front();
+        TRACE_SCOPE("led_confirm", frame.trace_id, TRACE_FLOW_END);
+
+        // Замер только по кадру, закрывшему ACK, и только без повторов
+        if (frame.seq == acked && !frame.retransmitted && received_ns > frame.sent_at_ns) {
+            updateRtt((received_ns - frame.sent_at_ns) / 1e6);
+        }
+
+        inflight_.pop_front();
+        if (resend_index_ > 0) resend_index_--;
+        released++;
+    }
+    if (released == 0) return;
+
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        delivery_stats_.acked += released;
+        delivery_stats_.in_flight = inflight_.size();
+        delivery_stats_.last_acked_seq = acked;
+    }
+
+    const unsigned int hz=4;
+    led2_->blink(hz); // rk_func_communication_confirmation
+}
+
+// Сколько осталось до таймаута ACK первого кадра окна (< 0 - истек);
+// false - ждать нечего
+bool SmartClient::ackTimeLeft(double& left_ms) const {
+    if (!acks_enabled_ || inflight_.empty() || resend_index_ == 0) return false;
+
+    double timeout_ms;
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        timeout_ms = ackTimeoutMs(delivery_stats_);
+    }
+
+    left_ms = timeout_ms - (monotonic_ns() - inflight_.front().sent_at_ns) / 1e6;
+    return true;
+}
+
+bool SmartClient::ackTimedOut() const {
+    double left_ms = 0;
+    return ackTimeLeft(left_ms) && left_ms < 0;
+}
+
+// Пауза потока отправки: до heartbeat, но не дольше срока ACK -
+// обрыв замечается через ackTimeoutMs(), а не на следующем heartbeat
+std::chrono::milliseconds SmartClient::senderWaitTime() const {
+    double left_ms = 0;
+    if (!ackTimeLeft(left_ms) || left_ms >= SMART_CLIENT_HEARTBEAT_MS) {
+        return std::chrono::milliseconds(SMART_CLIENT_HEARTBEAT_MS);
+    }
+    // +1: проснуться уже после срока, а не за долю миллисекунды до него
+    return std::chrono::milliseconds(left_ms < 0 ? 0 : static_cast<long>(left_ms) + 1);
+}
+
 void SmartClient::sendingLoop() {
     std::cout << "[ETHERNET] Sender thread started" << std::endl;
+    Tracer::setThreadName("eth-sender");
     
     int failed_heartbeats = 0;
-    const int MAX_FAILED_HEARTBEATS = 3;
+    const int MAX_FAILED_HEARTBEATS = SMART_CLIENT_MAX_FAILED_HEARTBEATS;
+
+    uring_send_ = false;
+    if (uring_active_) {
+        uring_send_ = uring_sender_.init() && uring_sender_.attach(socket_->get());
+        uring_generation_ = generation_;
+        if (!uring_send_) {
+            std::cerr << "[ETHERNET] io_uring sender setup failed (" << strerror(errno)
+                      << "), using send()" << std::endl;
+            uring_sender_.close();
+        }
+    }
     
     while (running_ && connected_) {
-        std::vector<uint8_t> data_to_send;
+        // Тот же аллокатор, что у очереди: move без копирования
+        QueuedFrame data_to_send(send_queue_.get_allocator());
         bool has_data = false;
+        bool has_resend = false;
+        bool has_ack = false;
+        uint32_t acked = 0;
+        uint64_t ack_received_ns = 0;
+        bool link_failed = false;
         
         {
+            // Окно и статистика RTT - до queue_mutex_ (stats_mutex_ не берется под ним)
+            const std::chrono::milliseconds wait_time = senderWaitTime();
             std::unique_lock<std::mutex> lock(queue_mutex_);
-            // Ждем 2 секунды или пока появится сообщение
-            if (queue_cv_.wait_for(lock, std::chrono::seconds(2),
-                [this] { return !send_queue_.empty() || !running_; })) {
+            // Ждем до heartbeat / срока ACK или пока появится сообщение / ACK
+            if (queue_cv_.wait_for(lock, wait_time,
+                [this] { return hasWorkLocked() || !running_; })) {
                 
                 if (!running_) break;
+
+                if (connection_failed_) {
+                    connection_failed_ = false;
+                    link_failed = failed_generation_ == generation_;
+                }
+
+                if (ack_pending_) {
+                    ack_pending_ = false;
+                    has_ack = true;
+                    acked = acked_seq_;
+                    ack_received_ns = ack_received_ns_;
+                }
                 
-                if (!send_queue_.empty()) {
+                if (link_failed) {
+                    // Сначала переключение, кадры подождут
+                } else if (resend_index_ < inflight_.size()) {
+                    has_resend = true;
+                } else if (!send_queue_.empty() && (!acks_enabled_ || inflight_.size() < window_)) {
                     data_to_send = std::move(send_queue_.front());
-                    send_queue_.pop();
+                    send_queue_.pop_front();
                     has_data = true;
-                    std::cout << "[ETHERNET] Got data from queue (" 
-                              << data_to_send.size() << " bytes)" << std::endl;
                 }
             }
         }
         
         if (!running_ || !connected_) break;
+
+        if (link_failed) {
+            std::cerr << "[ETHERNET] Receiver reported connection loss" << std::endl;
+            if (failover()) {
+                failed_heartbeats = 0;
+                continue;
+            }
+            connected_ = false;
+            running_ = false;
+            break;
+        }
+
+        if (has_ack) {
+            releaseAcked(acked, ack_received_ns);
+        }
+
+        if (ackTimedOut()) {
+            std::cerr << "[ETHERNET] No ACK for frame #" << inflight_.front().seq
+                      << ", connection dead!" << std::endl;
+            if (failover()) {
+                failed_heartbeats = 0;
+                continue;
+            }
+            connected_ = false;
+            running_ = false;
+            break;
+        }
+
+        if (has_resend) {
+            QueuedFrame& frame = inflight_[resend_index_];
+            TRACE_SCOPE("retransmit", frame.trace_id, TRACE_FLOW_STEP);
+            if (!sendFrame(frame.data.data(), frame.data.size(), frame.seq, FRAME_FLAG_RETRANSMIT)) {
+                std::cerr << "[ETHERNET] Failed to retransmit frame #" << frame.seq << std::endl;
+                if (failover()) {
+                    failed_heartbeats = 0;
+                    continue;
+                }
+                connected_ = false;
+                running_ = false;
+                break;
+            }
+            frame.retransmitted = true;
+            frame.sent_at_ns = monotonic_ns(); // отсчет таймаута ACK заново
+            resend_index_++;
+
+            std::lock_guard<std::mutex> lock(stats_mutex_);
+            delivery_stats_.retransmitted++;
+            continue;
+        }
         
         if (has_data) {
+            TRACE_SCOPE("dequeue_send", data_to_send.trace_id, TRACE_FLOW_STEP);
+            const uint32_t seq = acks_enabled_ ? next_seq_++ : 0;
+            data_to_send.seq = seq;
+            data_to_send.sent_at_ns = monotonic_ns();
+
+            // Кадр остается в окне до ACK; при обрыве он будет отправлен повторно
+            QueuedFrame* frame = &data_to_send;
+            if (acks_enabled_) {
+                inflight_.push_back(std::move(data_to_send));
+                resend_index_ = inflight_.size();
+                frame = &inflight_.back();
+
+                std::lock_guard<std::mutex> lock(stats_mutex_);
+                delivery_stats_.sent++;
+                delivery_stats_.in_flight = inflight_.size();
+            }
+
             // Отправляем данные из очереди
-            if (!sendDataInternal(data_to_send)) {
+            if (!sendFrame(frame->data.data(), frame->data.size(), seq, 0)) {
                 std::cerr << "[ETHERNET] Failed to send queued data" << std::endl;
+                if (!acks_enabled_) {
+                    // Без ACK кадр не в окне - возвращаем в начало очереди
+                    std::lock_guard<std::mutex> lock(queue_mutex_);
+                    send_queue_.push_front(std::move(data_to_send));
+                }
+                if (failover()) {
+                    failed_heartbeats = 0;
+                    continue;
+                }
                 connected_ = false;
                 running_ = false;
                 break;
             }
-            else{
+            else if (!acks_enabled_) {
+                TRACE_SCOPE("led_confirm", frame->trace_id, TRACE_FLOW_END);
                 const unsigned int hz=4;
                 led2_->blink(hz); // rk_func_communication_confirmation
             }
             continue; // Переходим к следующей итерации
         }
+
+        if (has_ack) continue;
         
-        // Если очередь пуста - heartbeat
-        std::this_thread::sleep_for(std::chrono::seconds(2));
+        // Если очередь пуста - heartbeat (пауза прерывается в stop() и новыми данными)
+        {
+            const std::chrono::milliseconds wait_time = senderWaitTime();
+            std::unique_lock<std::mutex> lock(queue_mutex_);
+            if (queue_cv_.wait_for(lock, wait_time,
+                [this] { return hasWorkLocked() || !running_; })) {
+                continue;
+            }
+        }
         
         if (!running_ || !connected_) break;
+        // Проснулись по сроку ACK, а не по heartbeat: проверка в начале цикла
+        if (ackTimedOut()) continue;
         
         // Heartbeat сообщение
         int counter = ++message_counter_;
-        std::string message = "PING#" + std::to_string(counter) + "\n";
+        TRACE_SCOPE("heartbeat", static_cast<uint64_t>(counter), TRACE_FLOW_NONE);
+        char message[32];
+        int length = snprintf(message, sizeof(message), "PING#%d\n", counter);
         
         // Отправляем с коротким таймаутом
-        struct timeval tv = {2, 0}; // 2 секунды таймаут
-        setsockopt(socket_->get(), SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
-        
-        ssize_t sent = send(socket_->get(), message.c_str(), message.length(), MSG_NOSIGNAL);
-        
-        // Восстанавливаем таймаут
-        tv.tv_sec = 10;
-        setsockopt(socket_->get(), SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+        ssize_t sent = -1;
+        if (uring_send_) {
+            if (uringSend(reinterpret_cast<const uint8_t*>(message), length, 2000)) sent = length;
+        } else {
+            struct timeval tv = {2, 0}; // 2 секунды таймаут
+            setsockopt(socket_->get(), SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+            
+            sent = send(socket_->get(), message, length, MSG_NOSIGNAL);
+            
+            // Восстанавливаем таймаут
+            tv.tv_sec = 10;
+            setsockopt(socket_->get(), SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+        }
         
         if (sent < 0) {
             failed_heartbeats++;
@@ -230,12 +896,20 @@ void SmartClient::sendingLoop() {
             
             if (failed_heartbeats >= MAX_FAILED_HEARTBEATS) {
                 std::cerr << "[ETHERNET] Too many failed heartbeats, connection dead!" << std::endl;
+                if (failover()) {
+                    failed_heartbeats = 0;
+                    continue;
+                }
                 connected_ = false;
                 running_ = false;
                 break;
             }
         } else if (sent == 0) {
             std::cerr << "[ETHERNET] Connection closed by server" << std::endl;
+            if (failover()) {
+                failed_heartbeats = 0;
+                continue;
+            }
             connected_ = false;
             running_ = false;
             break;
@@ -251,39 +925,131 @@ void SmartClient::sendingLoop() {
         }
     }
     
+    // Кольцо держит ссылку на сокет - освобождаем вместе с потоком
+    uring_sender_.close();
+    uring_send_ = false;
+
+    // Receiver мог ждать переключения, которого уже не будет
+    {
+        std::lock_guard<std::mutex> lock(conn_mutex_);
+    }
+    conn_cv_.notify_all();
+    
     std::cout << "[ETHERNET] Sender thread stopped" << std::endl;
 }
 
 void SmartClient::receivingLoop() {
     std::cout << "[ETHERNET] Receiver thread started" << std::endl;
+    Tracer::setThreadName("eth-receiver");
     
     char buffer[1024];
+    // Строки "ACK <seq>" могут прийти разрезанными между recv()
+    char line[128];
+    size_t line_length = 0;
+    uint64_t generation = 0;
+    int fd = -1;
+
+    // Кольцо приема: один multishot recv на соединение вместо getsockopt + recv
+    bool uring = uring_active_ && uring_receiver_.init();
+    if (uring_active_ && !uring) {
+        std::cerr << "[ETHERNET] io_uring receiver setup failed (" << strerror(errno)
+                  << "), using recv()" << std::endl;
+    }
+    uint64_t uring_generation = ~0ull;
     
     while (running_ && connected_) {
         if (!running_ || !connected_) break;
         
         memset(buffer, 0, sizeof(buffer));
-        
-        // Проверяем соединение перед приемом
-        if (!checkConnection()) {
-            std::cerr << "[ETHERNET] Connection lost in receiver" << std::endl;
-            connected_ = false;
-            running_ = false;
-            break;
+
+        // После failover работаем с новым сокетом, старый закрываем здесь:
+        // только receiver мог еще сидеть в recv() на нем
+        bool switched = false;
+        {
+            std::lock_guard<std::mutex> lock(conn_mutex_);
+            retired_socket_.reset();
+            fd = socket_->get();
+            if (generation != generation_) {
+                generation = generation_;
+                line_length = 0;
+            }
+            switched = receiver_generation_ != generation;
+            receiver_generation_ = generation;
+        }
+        // failover() ждет, пока старый сокет закрыт
+        if (switched) conn_cv_.notify_all();
+
+        const char* chunk = buffer;
+        ssize_t received = 0;
+        if (uring) {
+            if (uring_generation != generation) {
+                if (!uring_receiver_.attach(fd)) {
+                    std::cerr << "[ETHERNET] io_uring attach failed: " << strerror(errno) << std::endl;
+                    if (receiverLost(generation)) continue;
+                    break;
+                }
+                uring_generation = generation;
+            }
+
+            // Ошибки сокета приходят в результате recv - отдельная проверка не нужна
+            const uint8_t* data = nullptr;
+            received = uring_receiver_.receive(data, SMART_CLIENT_SOCKET_TIMEOUT_S * 1000);
+            if (received > 0) {
+                chunk = reinterpret_cast<const char*>(data);
+            } else if (received < 0) {
+                errno = received == -ETIME ? EAGAIN : static_cast<int>(-received);
+                received = -1;
+            }
+        } else {
+            // Проверяем соединение перед приемом
+            if (!checkConnection(fd)) {
+                std::cerr << "[ETHERNET] Connection lost in receiver" << std::endl;
+                if (receiverLost(generation)) continue;
+                break;
+            }
+            
+            // Пытаемся принять данные
+            received = recv(fd, buffer, sizeof(buffer) - 1, 0);
         }
-        
-        // Пытаемся принять данные
-        ssize_t received = recv(socket_->get(), buffer, sizeof(buffer) - 1, 0);
         
         if (received > 0) {
-            buffer[received] = '\0';
-            std::cout << "[ETHERNET] Received " << received << " bytes: " << buffer << std::endl;
-            const unsigned int hz=4;
-            led2_->blink(hz); // rk_func_communication_confirmation
+            TRACE_SCOPE("receive", 0, TRACE_FLOW_NONE);
+            bool other_data = false;
+            for (ssize_t i = 0; i < received; i++) {
+                if (chunk[i] != '\n' && line_length < sizeof(line) - 1) {
+                    line[line_length++] = chunk[i];
+                    continue;
+                }
+                line[line_length] = '\0';
+                line_length = 0;
+
+                uint32_t seq = 0;
+                if (parseAck(line, seq)) {
+                    uint64_t now = monotonic_ns();
+                    {
+                        std::lock_guard<std::mutex> lock(queue_mutex_);
+                        acked_seq_ = seq;
+                        ack_received_ns_ = now;
+                        ack_pending_ = true;
+                    }
+                    queue_cv_.notify_one();
+                } else {
+                    std::cout << "[ETHERNET] Received: " << line << std::endl;
+                    other_data = true;
+                }
+            }
+            if (uring) {
+                uring_receiver_.release();
+            }
+            if (other_data) {
+                const unsigned int hz=4;
+                led2_->blink(hz); // rk_func_communication_confirmation
+            }
+            // Без паузы: задержка ACK тормозит окно и искажает RTT
+            continue;
         } else if (received == 0) {
             std::cout << "[ETHERNET] Server disconnected" << std::endl;
-            connected_ = false;
-            running_ = false;
+            if (receiverLost(generation)) continue;
             break;
         } else {
             int err = errno;
@@ -293,8 +1059,7 @@ void SmartClient::receivingLoop() {
                 continue;
             } else if (err == ECONNRESET || err == EPIPE || err == ENOTCONN) {
                 std::cerr << "[ETHERNET] Connection error in receiver: " << strerror(err) << std::endl;
-                connected_ = false;
-                running_ = false;
+                if (receiverLost(generation)) continue;
                 break;
             } else {
                 std::cerr << "[ETHERNET] Receive error: " << strerror(err) << std::endl;
@@ -306,16 +1071,32 @@ void SmartClient::receivingLoop() {
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
     }
     
+    uring_receiver_.close();
     std::cout << "[ETHERNET] Receiver thread stopped" << std::endl;
 }
 
 void SmartClient::stop() {
-    if (!running_) return;
+    // Потоки могли завершиться сами (обрыв), но их все равно нужно join
+    if (!running_ && !sender_thread_.joinable() && !receiver_thread_.joinable()) return;
     
     std::cout << "[ETHERNET] Stopping client..." << std::endl;
     
     running_ = false;
     connected_ = false;
+
+    // Будим потоки: sender ждет на queue_cv_, receiver - в recv() или conn_cv_
+    queue_cv_.notify_all();
+    {
+        std::lock_guard<std::mutex> lock(conn_mutex_);
+        if (socket_->isValid()) {
+            shutdown(socket_->get(), SHUT_RDWR);
+        }
+    }
+    conn_cv_.notify_all();
+    {
+        std::lock_guard<std::mutex> lock(standby_mutex_);
+    }
+    standby_cv_.notify_all();
     
     // Даем время потокам завершиться
     if (sender_thread_.joinable()) {
@@ -327,6 +1108,17 @@ void SmartClient::stop() {
         receiver_thread_.join();
         std::cout << "[ETHERNET] Receiver thread joined" << std::endl;
     }
+
+    if (standby_thread_.joinable()) {
+        standby_thread_.join();
+        std::cout << "[ETHERNET] Standby thread joined" << std::endl;
+    }
+    {
+        std::lock_guard<std::mutex> lock(standby_mutex_);
+        standby_socket_.reset();
+        standby_ready_ = false;
+    }
+    retired_socket_.reset();
     
     // Очищаем сокет
     cleanup();
@@ -339,14 +1131,24 @@ bool SmartClient::isRunning() const {
 }
 
 bool SmartClient::isConnected() const {
-    if (!running_ || !connected_ || !socket_->isValid()) {
+    if (!running_ || !connected_) {
+        return false;
+    }
+
+    // Дескриптор может смениться при failover - берем актуальный
+    int fd = -1;
+    {
+        std::lock_guard<std::mutex> lock(conn_mutex_);
+        fd = socket_->get();
+    }
+    if (fd < 0) {
         return false;
     }
     
     int socket_error = 0;
     socklen_t len = sizeof(socket_error);
     
-    if (getsockopt(socket_->get(), SOL_SOCKET, SO_ERROR, &socket_error, &len) < 0) {
+    if (getsockopt(fd, SOL_SOCKET, SO_ERROR, &socket_error, &len) < 0) {
         // Не удалось проверить сокет - считаем что соединение разорвано
         return false;
     }
@@ -360,17 +1162,17 @@ bool SmartClient::isConnected() const {
     fd_set read_fds, except_fds;
     FD_ZERO(&read_fds);
     FD_ZERO(&except_fds);
-    FD_SET(socket_->get(), &read_fds);
-    FD_SET(socket_->get(), &except_fds);
+    FD_SET(fd, &read_fds);
+    FD_SET(fd, &except_fds);
     
-    int result = select(socket_->get() + 1, &read_fds, nullptr, &except_fds, &tv);
+    int result = select(fd + 1, &read_fds, nullptr, &except_fds, &tv);
     
     if (result < 0) {
         // Ошибка select
         return false;
     }
     
-    if (FD_ISSET(socket_->get(), &except_fds)) {
+    if (FD_ISSET(fd, &except_fds)) {
         // Исключительная ситуация на сокете
         return false;
     }
@@ -378,42 +1180,83 @@ bool SmartClient::isConnected() const {
     return true;
 }
 
-bool SmartClient::sendData(const std::vector<uint8_t>& data) {
-    if (!isConnected()) {
-        std::cerr << "[ETHERNET] Cannot send: not connected" << std::endl;
+bool SmartClient::sendData(const std::vector<uint8_t>& data, uint64_t trace_id) {
+    return sendData(data.data(), data.size(), trace_id);
+}
+
+bool SmartClient::sendData(const uint8_t* data, size_t size, uint64_t trace_id) {
+    TRACE_SCOPE("enqueue", trace_id, TRACE_FLOW_STEP);
+    // Без select(): sendData вызывается из потока датчика на каждом кадре.
+    // Без соединения кадр теряется молча, как при переполненной очереди
+    if (!running_ || !connected_) {
+        dropped_frames_++;
         return false;
     }
     
-    if (data.empty()) {
+    if (size == 0) {
         std::cout << "[ETHERNET] Warning: trying to send empty data" << std::endl;
         return true;
     }
+
+    // Больше кадра - не влезет в wire_buf_ без выделения памяти
+    if (size > SMART_CLIENT_MAX_FRAME_BYTES) {
+        dropped_frames_++;
+        return false;
+    }
     
     {
         std::lock_guard<std::mutex> lock(queue_mutex_);
-        send_queue_.push(data);
+        // Сервер не успевает (или соединение вот-вот оборвется): новые кадры
+        // теряем, а не копим без предела
+        if (send_queue_.size() >= SMART_CLIENT_MAX_QUEUED_FRAMES) {
+            dropped_frames_++;
+            return false;
+        }
+        try {
+            send_queue_.emplace_back(data, size, trace_id);
+        } catch (const std::bad_alloc&) {
+            // Арена кончилась: теряем кадр, как при переполненной очереди
+            dropped_frames_++;
+            return false;
+        }
     }
     
-    // Будим поток отправки
+    // Будим поток отправки (без вывода в консоль: вызывается на каждом кадре)
     queue_cv_.notify_one();
-    
-    std::cout << "[ETHERNET] Data queued for sending (" << data.size() << " bytes)" << std::endl;
     return true;
 }
 
-bool SmartClient::sendDataInternal(const std::vector<uint8_t>& data) {
-    if (!connected_ || !socket_->isValid() || data.empty()) {
+bool SmartClient::uringSend(const uint8_t* data, size_t size, int timeout_ms) {
+    // После failover в слот кольца ставим новый сокет
+    if (uring_generation_ != generation_) {
+        if (!uring_sender_.attach(socket_->get())) return false;
+        uring_generation_ = generation_;
+    }
+    return uring_sender_.send(data, size, timeout_ms);
+}
+
+bool SmartClient::sendDataInternal(const uint8_t* data, size_t size) {
+    if (!connected_ || !socket_->isValid() || size == 0) {
         return false;
     }
+    TRACE_SCOPE("socket_send", 0, TRACE_FLOW_NONE);
+
+    if (uring_send_) {
+        if (!uringSend(data, size, SMART_CLIENT_SEND_TIMEOUT_MS)) {
+            std::cerr << "[ETHERNET] Send error: " << strerror(errno) << std::endl;
+            return false;
+        }
+        return true;
+    }
     
     // Устанавливаем таймаут отправки
-    struct timeval tv = {5, 0};
+    struct timeval tv = {SMART_CLIENT_SEND_TIMEOUT_MS / 1000, 0};
     setsockopt(socket_->get(), SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
     
     // Отправляем данные
-    ssize_t total_sent = 0;
-    const uint8_t* buffer = data.data();
-    size_t total_size = data.size();
+    size_t total_sent = 0;
+    const uint8_t* buffer = data;
+    size_t total_size = size;
     
     while (total_sent < total_size) {
         ssize_t sent = send(socket_->get(), 
@@ -439,8 +1282,6 @@ bool SmartClient::sendDataInternal(const std::vector<uint8_t>& data) {
     // Восстанавливаем таймаут
     tv.tv_sec = 10;
     setsockopt(socket_->get(), SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
-    
-    std::cout << "[ETHERNET] Successfully sent " << total_size << " bytes" << std::endl;
     return true;
 }
 
@@ -448,13 +1289,15 @@ int SmartClient::getMessageCount() const {
     return message_counter_;
 }
 
-bool SmartClient::checkEthernetLink() {
+IfaceLinkMonitor::IfaceLinkMonitor(const std::string& iface) : iface_(iface) {}
+
+bool IfaceLinkMonitor::isLinkUp() {
     int sock = socket(AF_INET, SOCK_DGRAM, 0);
     if (sock < 0) return false;
     
     struct ifreq ifr;
     memset(&ifr, 0, sizeof(ifr));
-    strncpy(ifr.ifr_name, "eth0", IFNAMSIZ - 1);
+    strncpy(ifr.ifr_name, iface_.c_str(), IFNAMSIZ - 1);
     
     // Получаем флаги интерфейса
     if (ioctl(sock, SIOCGIFFLAGS, &ifr) < 0) {
@@ -467,4 +1310,8 @@ bool SmartClient::checkEthernetLink() {
     
     close(sock);
     return is_up && is_running;
-}
\ No newline at end of file
+}
+
+bool SmartClient::checkEthernetLink() {
+    return link_->isLinkUp();
+}
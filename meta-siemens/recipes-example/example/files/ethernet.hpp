@@ -3,23 +3,45 @@
 
 #include <memory>
 #include <string>
+#include <chrono>
 #include <atomic>
 #include <thread>
 #include <functional>
 #include <mutex>
 #include <condition_variable>
-#include <queue>
+#include <deque>
+#include <vector>
+#include <memory_resource>
 
-#include "button-led.hpp"
+#include "hal.hpp"
+#include "compression.hpp"
+#include "uring.hpp"
+
+#define SMART_CLIENT_MAX_FRAME_BYTES (64 * 1024)  // больше - sendData() теряет кадр
+#define SMART_CLIENT_MAX_QUEUED_FRAMES 1024 // очередь отправки, сверх - потеря кадра
+#define SMART_CLIENT_SEND_TIMEOUT_MS 5000   // на один кадр
+#define SMART_CLIENT_HEARTBEAT_MS 2000      // PING после паузы без данных
+#define SMART_CLIENT_MAX_FAILED_HEARTBEATS 3
+
+// Подтверждения доставки (protocol.hpp, "ACK <seq>")
+#define SMART_CLIENT_ACK_WINDOW 32          // кадров без подтверждения
+#define SMART_CLIENT_ACK_TIMEOUT_MIN_MS 3000 // нет ACK дольше max(этого, 4*RTO) - обрыв
+#define SMART_CLIENT_RTO_INITIAL_MS 1000    // RFC 6298
+#define SMART_CLIENT_RTO_MIN_MS 200
+
+// Горячий резерв: второе соединение держится готовым к переключению
+#define SMART_CLIENT_SOCKET_TIMEOUT_S 10
+#define SMART_CLIENT_STANDBY_CONNECT_TIMEOUT_MS 1000
+#define SMART_CLIENT_STANDBY_RETRY_MS 500
 
 class SmartSocket {
 private:
-    std::unique_ptr<int, std::function<void(int*)>> socket_fd_;
+    int socket_fd_ = -1;
     
 public:
     SmartSocket();
     explicit SmartSocket(int fd);
-    ~SmartSocket() = default;
+    ~SmartSocket();
     
     bool create();
     int get() const;
@@ -30,32 +52,175 @@ public:
     SmartSocket(const SmartSocket&) = delete;
     SmartSocket& operator=(const SmartSocket&) = delete;
     
-    SmartSocket(SmartSocket&&) = default;
-    SmartSocket& operator=(SmartSocket&&) = default;
+    SmartSocket(SmartSocket&& other) noexcept;
+    SmartSocket& operator=(SmartSocket&& other) noexcept;
+};
+
+// Состояние линка через SIOCGIFFLAGS (IFF_UP && IFF_RUNNING)
+class IfaceLinkMonitor : public LinkMonitor {
+private:
+    std::string iface_;
+
+public:
+    explicit IfaceLinkMonitor(const std::string& iface);
+
+    bool isLinkUp() override;
+};
+
+// Кадр в очереди отправки; память из того же pmr-ресурса, что и очередь
+struct QueuedFrame {
+    using allocator_type = std::pmr::polymorphic_allocator<uint8_t>;
+
+    std::pmr::vector<uint8_t> data;
+    uint64_t trace_id = 0;
+    uint32_t seq = 0;            // назначается при первой отправке
+    uint64_t sent_at_ns = 0;     // CLOCK_MONOTONIC первой отправки
+    bool retransmitted = false;  // такие кадры не дают замер RTT (алгоритм Карна)
+
+    explicit QueuedFrame(const allocator_type& alloc) : data(alloc) {}
+    QueuedFrame(const uint8_t* bytes, size_t size, uint64_t id, const allocator_type& alloc)
+        : data(bytes, bytes + size, alloc), trace_id(id) {}
+    QueuedFrame(QueuedFrame&& other, const allocator_type& alloc)
+        : data(std::move(other.data), alloc), trace_id(other.trace_id), seq(other.seq),
+          sent_at_ns(other.sent_at_ns), retransmitted(other.retransmitted) {}
+
+    QueuedFrame(QueuedFrame&&) = default;
+    QueuedFrame& operator=(QueuedFrame&&) = default;
+};
+
+struct DeliveryStats {
+    uint64_t sent = 0;            // кадров с номером (первая отправка)
+    uint64_t acked = 0;
+    uint64_t retransmitted = 0;
+    size_t in_flight = 0;
+    uint32_t last_acked_seq = 0;
+    double srtt_ms = 0.0;         // 0 - замеров еще не было
+    double rttvar_ms = 0.0;
+    double rto_ms = SMART_CLIENT_RTO_INITIAL_MS;
+    uint64_t failovers = 0;       // переключений на резервное соединение
+    double last_failover_us = 0.0;
+    uint64_t dropped = 0;         // не попали в очередь отправки (переполнена)
 };
 
+// Путь send/recv (uring.hpp); URING без поддержки ядра откатывается на CLASSIC
+enum class IoBackend { CLASSIC, URING };
+
+// Итог HELLO для одного соединения
+struct NegotiatedProtocol {
+    bool framed = false;
+    PayloadCodec* codec = nullptr;
+    bool acks = false;
+};
+
+// Оценка RTT по RFC 6298 (srtt/rttvar/rto в stats)
+void updateRttEstimate(DeliveryStats& stats, double sample_ms);
+// Сколько ждать ACK самого старого кадра, прежде чем считать связь мертвой
+double ackTimeoutMs(const DeliveryStats& stats);
+
 class SmartClient {
 private:
+    // socket_ меняет только поток отправки (failover) под conn_mutex_;
+    // receiver и main берут дескриптор под тем же мьютексом
     std::unique_ptr<SmartSocket> socket_;
+    std::unique_ptr<SmartSocket> retired_socket_; // закрывает только receiver
+    uint64_t generation_ = 0;                     // номер соединения
+    uint64_t receiver_generation_ = 0;            // до какого соединения дошел receiver
+    mutable std::mutex conn_mutex_;
+    std::condition_variable conn_cv_;
     std::atomic<bool> connected_{false};
     std::atomic<bool> running_{false};
     std::thread sender_thread_;
     std::thread receiver_thread_;
     std::atomic<int> message_counter_{0};
 
-    std::queue<std::vector<uint8_t>> send_queue_;
+    // Очередь и кадры берут память из RuntimeMemory::resource()
+    std::pmr::deque<QueuedFrame> send_queue_;
     mutable std::mutex queue_mutex_;
     std::condition_variable queue_cv_;
+    std::atomic<uint64_t> dropped_frames_{0};
+
+    // Отправленные, но не подтвержденные кадры. Меняет только поток отправки
+    // (и start(), когда потоков нет); receiver лишь сообщает acked_seq_.
+    std::pmr::deque<QueuedFrame> inflight_;
+    size_t resend_index_ = 0;    // inflight_[resend_index_..] ждут повтора
+    size_t window_ = SMART_CLIENT_ACK_WINDOW;
+    bool acks_enabled_ = false;
+    uint32_t next_seq_ = 1;
+
+    // Под queue_mutex_
+    bool ack_pending_ = false;
+    uint32_t acked_seq_ = 0;
+    uint64_t ack_received_ns_ = 0;
+    bool connection_failed_ = false;   // receiver: соединение failed_generation_ умерло
+    uint64_t failed_generation_ = 0;
+
+    // Горячий резерв (setupStandby); поля под standby_mutex_
+    bool standby_enabled_ = false;
+    std::string active_ip_;
+    int active_port_ = 0;
+    std::string standby_ip_;
+    int standby_port_ = 0;
+    std::unique_ptr<SmartSocket> standby_socket_;
+    NegotiatedProtocol standby_protocol_;
+    bool standby_ready_ = false;
+    uint32_t standby_pings_ = 0;
+    std::thread standby_thread_;
+    std::mutex standby_mutex_;
+    std::condition_variable standby_cv_;
     
+    // io_uring: кольцо отправки живет в потоке отправки, приема - в receiver
+    IoBackend io_backend_ = IoBackend::CLASSIC;
+    std::atomic<bool> uring_active_{false};  // start() проверил поддержку ядра
+    UringSender uring_sender_;
+    bool uring_send_ = false;                // кольцо отправки создано
+    uint64_t uring_generation_ = 0;          // сокет в слоте отправки
+    UringReceiver uring_receiver_;
+
     void sendingLoop();
     void receivingLoop();
-    bool checkConnection();
+    bool checkConnection(int fd);
     void cleanup();
     
-    SysfsLedController* led1_ = nullptr;
-    SysfsLedController* led2_ = nullptr;
+    LedDevice* led1_ = nullptr;
+    LedDevice* led2_ = nullptr;
+
+    IfaceLinkMonitor default_link_{"eth0"};
+    LinkMonitor* link_ = &default_link_;
     
-    bool sendDataInternal(const std::vector<uint8_t>& data);
+    bool sendDataInternal(const uint8_t* data, size_t size);
+    bool uringSend(const uint8_t* data, size_t size, int timeout_ms);
+
+    // Сжатие: кодеки в порядке предпочтения, выбор - при каждом подключении.
+    // active_codec_/framed_/acks_enabled_ пишет applyProtocol() под stats_mutex_
+    std::vector<std::unique_ptr<PayloadCodec>> codecs_;
+    PayloadCodec* active_codec_ = nullptr;
+    bool framed_ = false;
+    std::vector<uint8_t> wire_buf_;
+    // Серверы ("ip:port"), не ответившие на HELLO: к ним HELLO больше не шлем
+    std::vector<std::string> legacy_endpoints_;
+    std::mutex legacy_mutex_;
+    CompressionStats compression_stats_;
+    DeliveryStats delivery_stats_;
+    mutable std::mutex stats_mutex_;
+
+    bool openConnection(const std::string& ip, int port, SmartSocket& socket, int connect_timeout_ms);
+    // false - соединение закрылось или сервер ответил неразборчиво; молчание - raw
+    bool negotiateProtocol(int fd, const std::string& ip, int port, NegotiatedProtocol& result);
+    void markLegacyEndpoint(const std::string& endpoint);
+    void applyProtocol(const NegotiatedProtocol& protocol);
+    bool failover();
+    bool receiverLost(uint64_t generation);
+    void standbyLoop();
+    bool checkStandbyLocked();
+    bool sendFrame(const uint8_t* data, size_t size, uint32_t seq, uint16_t flags);
+
+    bool hasWorkLocked() const;
+    void restoreInflight();
+    void releaseAcked(uint32_t acked, uint64_t received_ns);
+    void updateRtt(double sample_ms);
+    bool ackTimeLeft(double& left_ms) const;
+    bool ackTimedOut() const;
+    std::chrono::milliseconds senderWaitTime() const;
     
 public:
     SmartClient();
@@ -73,9 +238,29 @@ public:
     // Получить статистику
     int getMessageCount() const;
 
-    bool sendData(const std::vector<uint8_t>& data);
+    bool sendData(const std::vector<uint8_t>& data, uint64_t trace_id = 0);
+    // Без промежуточного vector (кадры из общей памяти, shm_ingest.hpp)
+    bool sendData(const uint8_t* data, size_t size, uint64_t trace_id = 0);
+
+    void setupLed(LedDevice* led1, LedDevice* led2);
+    void setupLinkMonitor(LinkMonitor* link);
+
+    // Сжатие полезной нагрузки (вызывать до start())
+    void addCodec(std::unique_ptr<PayloadCodec> codec);
+    const char* getCodecName() const;
+    CompressionStats getCompressionStats() const;
+
+    // Окно неподтвержденных кадров (вызывать до start()); 0 - не предлагать ACK
+    void setAckWindow(size_t frames);
+
+    // Горячий резерв (вызывать до start()): второе соединение с HELLO держится
+    // открытым, при обрыве данные сразу идут через него. Пустой ip - тот же сервер.
+    void setupStandby(const std::string& ip, int port);
+    DeliveryStats getDeliveryStats() const;
 
-    void setupLed(SysfsLedController* led1, SysfsLedController* led2);
+    // Путь ввода-вывода (вызывать до start())
+    void setIoBackend(IoBackend backend);
+    const char* getIoBackendName() const;
     
     // Удаляем копирование
     SmartClient(const SmartClient&) = delete;
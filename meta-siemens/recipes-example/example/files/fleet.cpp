@@ -0,0 +1,646 @@
+#include <iostream>
+#include <cerrno>
+#include <cstring>
+#include <random>
+#include <fcntl.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+
+#include "fleet.hpp"
+#include "app.hpp"
+#include "protocol.hpp"
+
+using namespace std::chrono;
+
+static constexpr uint64_t STOP_TAG = UINT64_MAX;
+
+static uint64_t elapsed_us(FleetClock::time_point from, FleetClock::time_point to) {
+    return to > from ? duration_cast<microseconds>(to - from).count() : 0;
+}
+
+static void put_le(uint8_t* dst, uint64_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; i++) {
+        dst[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+void LatencyHistogram::add(uint64_t us) {
+    int index;
+    if (us < SUB_BUCKETS) {
+        index = static_cast<int>(us);
+    } else {
+        int msb = 63 - __builtin_clzll(us);
+        index = (msb - 2) * SUB_BUCKETS + static_cast<int>((us >> (msb - 3)) & (SUB_BUCKETS - 1));
+    }
+    if (index >= BUCKETS) index = BUCKETS - 1;
+
+    buckets_[index]++;
+    count_++;
+    if (us > max_us_) max_us_ = us;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (int i = 0; i < BUCKETS; i++) {
+        buckets_[i] += other.buckets_[i];
+    }
+    count_ += other.count_;
+    if (other.max_us_ > max_us_) max_us_ = other.max_us_;
+}
+
+double LatencyHistogram::percentileMs(double percentile) const {
+    if (count_ == 0) return 0.0;
+
+    uint64_t rank = static_cast<uint64_t>(percentile / 100.0 * count_ + 0.5);
+    if (rank == 0) rank = 1;
+
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKETS; i++) {
+        seen += buckets_[i];
+        if (seen < rank) continue;
+
+        // Середина интервала, но не больше максимума
+        uint64_t value = static_cast<uint64_t>(i);
+        if (i >= SUB_BUCKETS) {
+            int msb = i / SUB_BUCKETS + 2;
+            uint64_t width = 1ull << (msb - 3);
+            value = ((SUB_BUCKETS + static_cast<uint64_t>(i % SUB_BUCKETS)) << (msb - 3)) + width / 2;
+        }
+        return (value < max_us_ ? value : max_us_) / 1000.0;
+    }
+    return maxMs();
+}
+
+void FleetStats::merge(const FleetStats& other) {
+    online += other.online;
+    connect_attempts += other.connect_attempts;
+    connects += other.connects;
+    connect_failures += other.connect_failures;
+    hello_timeouts += other.hello_timeouts;
+    disconnects += other.disconnects;
+    alerts += other.alerts;
+    link_flaps += other.link_flaps;
+    frames_sent += other.frames_sent;
+    frames_acked += other.frames_acked;
+    frames_retransmitted += other.frames_retransmitted;
+    frames_dropped += other.frames_dropped;
+    heartbeats += other.heartbeats;
+    bytes_sent += other.bytes_sent;
+    tcp_connect.merge(other.tcp_connect);
+    handshake.merge(other.handshake);
+    ack_rtt.merge(other.ack_rtt);
+}
+
+FleetWorker::FleetWorker(const FleetConfig& config, unsigned int first_device, unsigned int device_count)
+    : config_(config), first_device_(first_device), devices_(device_count) {
+    memset(&server_addr_, 0, sizeof(server_addr_));
+    server_addr_.sin_family = AF_INET;
+    server_addr_.sin_port = htons(config_.port);
+    inet_pton(AF_INET, config_.ip.c_str(), &server_addr_.sin_addr);
+
+    if (config_.rate_hz > 0) {
+        frame_period_ = duration_cast<nanoseconds>(duration<double>(1.0 / config_.rate_hz));
+    }
+    frame_buf_.reserve(2 + config_.samples_per_frame * (10 + SENSOR_SAMPLE_MAX_BYTES));
+    wire_buf_.reserve(PROTOCOL_FRAME_HEADER_SIZE + SMART_CLIENT_MAX_FRAME_BYTES);
+}
+
+FleetWorker::~FleetWorker() {
+    stop();
+}
+
+bool FleetWorker::start(FleetClock::time_point origin) {
+    if (running_) return true;
+
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    stop_fd_ = eventfd(0, EFD_CLOEXEC);
+    if (epoll_fd_ < 0 || stop_fd_ < 0) {
+        std::cerr << "[FLEET] Failed to create epoll/eventfd: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.u64 = STOP_TAG;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, stop_fd_, &event);
+
+    // Первые подключения и фазы кадров/пропаданий линка разнесены по времени
+    std::mt19937 random(first_device_ + 1);
+    const unsigned int total = config_.devices ? config_.devices : 1;
+    for (size_t i = 0; i < devices_.size(); i++) {
+        Device& device = devices_[i];
+        device.id = first_device_ + static_cast<unsigned int>(i);
+        device.next_attempt = origin + milliseconds(static_cast<uint64_t>(config_.ramp_ms) * device.id / total);
+        device.last_send = device.next_attempt;
+
+        if (frame_period_.count() > 0) {
+            device.next_frame = origin + nanoseconds(random() % frame_period_.count());
+        }
+        if (config_.flap_every_ms > 0) {
+            device.next_flap = origin + milliseconds(config_.ramp_ms + random() % config_.flap_every_ms);
+        }
+    }
+
+    running_ = true;
+    thread_ = std::thread(&FleetWorker::workerLoop, this);
+    return true;
+}
+
+void FleetWorker::stop() {
+    if (!running_) return;
+
+    running_ = false;
+    uint64_t one = 1;
+    if (write(stop_fd_, &one, sizeof(one)) < 0) {
+        std::cerr << "[FLEET] Failed to wake worker: " << strerror(errno) << std::endl;
+    }
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+
+    for (Device& device : devices_) {
+        if (device.fd >= 0) {
+            ::close(device.fd);
+            device.fd = -1;
+        }
+    }
+    ::close(epoll_fd_);
+    ::close(stop_fd_);
+    epoll_fd_ = -1;
+    stop_fd_ = -1;
+}
+
+FleetStats FleetWorker::getStats() const {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    return stats_;
+}
+
+void FleetWorker::schedule(size_t index, FleetClock::time_point when) {
+    Device& device = devices_[index];
+    if (device.scheduled == when) return; // такая запись уже в куче
+    device.scheduled = when;
+    timers_.push({when, index});
+}
+
+void FleetWorker::workerLoop() {
+    struct epoll_event events[256];
+
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        auto now = FleetClock::now();
+        for (size_t i = 0; i < devices_.size(); i++) {
+            devices_[i].scheduled = FleetClock::time_point::max();
+            schedule(i, now);
+        }
+    }
+
+    while (running_) {
+        auto now = FleetClock::now();
+        int timeout_ms = 1000;
+        if (!timers_.empty()) {
+            auto next = timers_.top().first;
+            timeout_ms = next > now ? static_cast<int>(duration_cast<milliseconds>(next - now).count()) + 1 : 0;
+        }
+
+        int count = epoll_wait(epoll_fd_, events, sizeof(events) / sizeof(events[0]), timeout_ms);
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "[FLEET] epoll_wait failed: " << strerror(errno) << std::endl;
+            break;
+        }
+
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        now = FleetClock::now();
+
+        for (int i = 0; i < count; i++) {
+            if (events[i].data.u64 == STOP_TAG) return;
+
+            const size_t index = events[i].data.u64;
+            Device& device = devices_[index];
+            handleEvent(device, events[i].events, now);
+            schedule(index, tick(device, now));
+        }
+
+        // Только устройства, чей срок наступил
+        while (!timers_.empty() && timers_.top().first <= now) {
+            const Timer timer = timers_.top();
+            timers_.pop();
+            Device& device = devices_[timer.second];
+            if (device.scheduled != timer.first) continue; // срок уже перенесен
+            device.scheduled = FleetClock::time_point::max();
+            schedule(timer.second, tick(device, now));
+        }
+    }
+}
+
+FleetClock::time_point FleetWorker::tick(Device& device, FleetClock::time_point now) {
+    if (config_.flap_every_ms > 0 && now >= device.next_flap) {
+        device.next_flap += milliseconds(config_.flap_every_ms);
+        linkDown(device, now);
+    }
+
+    switch (device.state) {
+    case State::LINK_DOWN:
+        // Как ButtonLedApp: возврат линка не снимает ALERT, ждем нажатия кнопки
+        if (now >= device.link_up_at + milliseconds(config_.alert_hold_ms)) {
+            device.state = State::IDLE;
+            device.next_attempt = now;
+        }
+        break;
+    case State::IDLE:
+        if (now >= device.next_attempt) startConnect(device, now);
+        break;
+    case State::CONNECTING:
+        if (now >= device.deadline) disconnect(device, now, true);
+        break;
+    case State::HELLO:
+        // Как negotiateProtocol(): нет ответа - работаем без заголовков
+        if (now >= device.deadline) {
+            stats_.hello_timeouts++;
+            device.legacy = true;
+            device.framed = false;
+            device.compressed = false;
+            device.acks = false;
+            goOnline(device, now);
+        }
+        break;
+    case State::ONLINE:
+        break;
+    }
+
+    // Датчик работает независимо от соединения; пропущенные тики не догоняем
+    if (frame_period_.count() > 0 && now >= device.next_frame) {
+        produceFrame(device, now);
+        device.next_frame += frame_period_;
+        if (device.next_frame <= now) device.next_frame = now + frame_period_;
+    }
+
+    if (device.state == State::ONLINE) {
+        if (device.acks && device.resend_index > 0 && !device.inflight.empty() &&
+            elapsed_us(device.inflight.front().sent_at, now) / 1000.0 > ackTimeoutMs(device.delivery)) {
+            disconnect(device, now, false);
+        } else {
+            pump(device, now);
+            if (device.state == State::ONLINE && device.out.empty() &&
+                now - device.last_send >= milliseconds(SMART_CLIENT_HEARTBEAT_MS)) {
+                char message[32];
+                int length = snprintf(message, sizeof(message), "PING#%u\n", ++device.ping_counter);
+                device.out.insert(device.out.end(), message, message + length);
+                device.last_send = now;
+                stats_.heartbeats++;
+                if (!flush(device)) disconnect(device, now, false);
+            }
+        }
+    }
+
+    // Ближайшее событие устройства
+    FleetClock::time_point next = now + seconds(1);
+    auto earliest = [&next](FleetClock::time_point when) {
+        if (when < next) next = when;
+    };
+    if (config_.flap_every_ms > 0) earliest(device.next_flap);
+    if (frame_period_.count() > 0) earliest(device.next_frame);
+    switch (device.state) {
+    case State::LINK_DOWN: earliest(device.link_up_at + milliseconds(config_.alert_hold_ms)); break;
+    case State::IDLE: earliest(device.next_attempt); break;
+    case State::CONNECTING:
+    case State::HELLO: earliest(device.deadline); break;
+    case State::ONLINE:
+        earliest(device.last_send + milliseconds(SMART_CLIENT_HEARTBEAT_MS));
+        if (device.acks && !device.inflight.empty()) {
+            earliest(device.inflight.front().sent_at +
+                     microseconds(static_cast<uint64_t>(ackTimeoutMs(device.delivery) * 1000)));
+        }
+        break;
+    }
+    return next;
+}
+
+void FleetWorker::handleEvent(Device& device, uint32_t events, FleetClock::time_point now) {
+    if (device.fd < 0) return; // событие от уже закрытого сокета
+
+    if (device.state == State::CONNECTING) {
+        int error = 0;
+        socklen_t len = sizeof(error);
+        getsockopt(device.fd, SOL_SOCKET, SO_ERROR, &error, &len);
+        if (error != 0) {
+            disconnect(device, now, true);
+        } else if (events & EPOLLOUT) {
+            onConnected(device, now);
+        }
+        return;
+    }
+
+    if (events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+        receive(device, now);
+    }
+    if (device.fd >= 0 && (events & EPOLLOUT)) {
+        if (!flush(device)) {
+            disconnect(device, now, device.state != State::ONLINE);
+        } else {
+            pump(device, now);
+        }
+    }
+}
+
+void FleetWorker::startConnect(Device& device, FleetClock::time_point now) {
+    stats_.connect_attempts++;
+    device.connect_started = now;
+
+    device.fd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (device.fd < 0) {
+        std::cerr << "[FLEET] Failed to create socket: " << strerror(errno) << std::endl;
+        disconnect(device, now, true);
+        return;
+    }
+
+    int keepalive = 1;
+    setsockopt(device.fd, SOL_SOCKET, SO_KEEPALIVE, &keepalive, sizeof(keepalive));
+
+    struct epoll_event event;
+    device.epoll_events = EPOLLIN | EPOLLOUT;
+    event.events = device.epoll_events;
+    event.data.u64 = &device - devices_.data();
+    epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, device.fd, &event);
+
+    if (::connect(device.fd, (struct sockaddr*)&server_addr_, sizeof(server_addr_)) == 0) {
+        onConnected(device, now);
+    } else if (errno == EINPROGRESS) {
+        device.state = State::CONNECTING;
+        device.deadline = now + milliseconds(FLEET_CONNECT_TIMEOUT_MS);
+    } else {
+        disconnect(device, now, true);
+    }
+}
+
+void FleetWorker::onConnected(Device& device, FleetClock::time_point now) {
+    stats_.tcp_connect.add(elapsed_us(device.connect_started, now));
+
+    // Как SmartClient: без кодеков и окна, а также серверу, уже промолчавшему
+    // на HELLO, он не отправляется
+    if ((!config_.compress && !config_.acks) || device.legacy) {
+        device.framed = false;
+        device.compressed = false;
+        device.acks = false;
+        goOnline(device, now);
+        return;
+    }
+
+    std::string hello = buildHello(config_.compress ? "lz,none" : "none", config_.acks);
+    device.out.insert(device.out.end(), hello.begin(), hello.end());
+    device.state = State::HELLO;
+    device.deadline = now + milliseconds(PROTOCOL_HELLO_TIMEOUT_MS);
+    if (!flush(device)) {
+        disconnect(device, now, true);
+    }
+}
+
+void FleetWorker::onHelloReply(Device& device, const char* reply, FleetClock::time_point now) {
+    std::string codec_name;
+    bool ack = false;
+    bool accepted = parseHelloReply(reply, codec_name, ack);
+    const bool known_codec = codec_name == "none" || (codec_name == codec_.name() && config_.compress);
+    if (accepted && !known_codec) {
+        // Как SmartClient::negotiateProtocol(): сервер ждет кадры в чужом
+        // кодеке - подключение не удалось
+        disconnect(device, now, true);
+        return;
+    }
+    device.legacy = !accepted;
+    device.framed = accepted;
+    device.compressed = device.framed && codec_name == codec_.name();
+    device.acks = device.framed && ack && config_.acks;
+
+    stats_.handshake.add(elapsed_us(device.connect_started, now));
+    goOnline(device, now);
+}
+
+void FleetWorker::goOnline(Device& device, FleetClock::time_point now) {
+    device.state = State::ONLINE;
+    device.attempts = 0;
+    device.last_send = now;
+    stats_.connects++;
+    stats_.online++;
+
+    // Неподтвержденные кадры прошлого соединения - как SmartClient::restoreInflight()
+    if (device.acks) {
+        device.resend_index = 0;
+    } else {
+        while (!device.inflight.empty()) {
+            device.queue.push_front(std::move(device.inflight.back()));
+            device.inflight.pop_back();
+        }
+        device.resend_index = 0;
+    }
+    pump(device, now);
+}
+
+void FleetWorker::disconnect(Device& device, FleetClock::time_point now, bool failed_attempt) {
+    if (device.fd >= 0) {
+        ::close(device.fd); // close() убирает сокет из epoll
+        device.fd = -1;
+    }
+    device.out.clear();
+    device.out_offset = 0;
+    device.line_length = 0;
+    device.epoll_events = 0;
+
+    if (device.state == State::ONLINE) {
+        stats_.online--;
+        stats_.disconnects++;
+    }
+    if (failed_attempt) {
+        stats_.connect_failures++;
+    }
+
+    // ButtonLedApp: каждая неудача - попытка, после APP_MAX_ATTEMPTS - ALERT
+    device.state = State::IDLE;
+    if (++device.attempts >= APP_MAX_ATTEMPTS) {
+        stats_.alerts++;
+        device.attempts = 0;
+        device.next_attempt = now + milliseconds(config_.alert_hold_ms);
+    } else {
+        device.next_attempt = now + milliseconds(APP_LOOP_PERIOD_MS);
+    }
+}
+
+void FleetWorker::linkDown(Device& device, FleetClock::time_point now) {
+    stats_.link_flaps++;
+    device.attempts = 0;   // обрыв из-за линка - не неудачная попытка, второго ALERT нет
+    if (device.fd >= 0) {
+        disconnect(device, now, false);
+    }
+    // ButtonLedApp уходит в ALERT сразу при пропадании линка
+    if (device.state != State::LINK_DOWN) stats_.alerts++;
+    device.state = State::LINK_DOWN;
+    device.attempts = 0;
+    device.link_up_at = now + milliseconds(config_.flap_for_ms);
+}
+
+void FleetWorker::produceFrame(Device& device, FleetClock::time_point now) {
+    // sink из main(): пока клиент не запущен, кадр теряется
+    if (device.state != State::ONLINE || device.queue.size() >= FLEET_MAX_QUEUED_FRAMES) {
+        stats_.frames_dropped++;
+        return;
+    }
+
+    // Формат кадра - как в SensorAcquisition (sensor.hpp)
+    const uint64_t timestamp = duration_cast<nanoseconds>(now.time_since_epoch()).count();
+    frame_buf_.resize(2);
+    for (unsigned int i = 0; i < config_.samples_per_frame; i++) {
+        size_t offset = frame_buf_.size();
+        frame_buf_.resize(offset + 10 + SENSOR_SAMPLE_MAX_BYTES);
+        size_t size = sensor_.read(frame_buf_.data() + offset + 10, SENSOR_SAMPLE_MAX_BYTES);
+        put_le(frame_buf_.data() + offset, timestamp, 8);
+        put_le(frame_buf_.data() + offset + 8, size, 2);
+        frame_buf_.resize(offset + 10 + size);
+    }
+    put_le(frame_buf_.data(), config_.samples_per_frame, 2);
+
+    PendingFrame frame;
+    frame.data = frame_buf_;
+    device.queue.push_back(std::move(frame));
+    pump(device, now);
+}
+
+void FleetWorker::appendFrame(Device& device, const PendingFrame& frame, uint16_t flags) {
+    if (!device.framed) {
+        device.out.insert(device.out.end(), frame.data.begin(), frame.data.end());
+        return;
+    }
+
+    FrameHeader header;
+    buildFrame(device.compressed ? &codec_ : nullptr, frame.data.data(), frame.data.size(),
+               frame.seq, flags, wire_buf_, header);
+    device.out.insert(device.out.end(), wire_buf_.begin(), wire_buf_.end());
+}
+
+void FleetWorker::pump(Device& device, FleetClock::time_point now) {
+    if (device.state != State::ONLINE) return;
+
+    bool appended = false;
+    while (device.out.size() - device.out_offset < FLEET_MAX_OUT_BYTES) {
+        if (device.acks && device.resend_index < device.inflight.size()) {
+            PendingFrame& frame = device.inflight[device.resend_index++];
+            appendFrame(device, frame, FRAME_FLAG_RETRANSMIT);
+            frame.retransmitted = true;
+            frame.sent_at = now;
+            stats_.frames_retransmitted++;
+            appended = true;
+            continue;
+        }
+
+        if (device.queue.empty()) break;
+        if (device.acks && device.inflight.size() >= SMART_CLIENT_ACK_WINDOW) break;
+
+        PendingFrame frame = std::move(device.queue.front());
+        device.queue.pop_front();
+        stats_.frames_sent++;
+        appended = true;
+
+        if (device.acks) {
+            frame.seq = device.next_seq++;
+            frame.sent_at = now;
+            device.inflight.push_back(std::move(frame));
+            device.resend_index = device.inflight.size();
+            appendFrame(device, device.inflight.back(), 0);
+        } else {
+            appendFrame(device, frame, 0);
+        }
+    }
+
+    if (!appended) return;
+    device.last_send = now;
+    if (!flush(device)) {
+        disconnect(device, now, false);
+    }
+}
+
+bool FleetWorker::flush(Device& device) {
+    while (device.out_offset < device.out.size()) {
+        ssize_t sent = send(device.fd, device.out.data() + device.out_offset,
+                            device.out.size() - device.out_offset, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (sent > 0) {
+            device.out_offset += sent;
+            stats_.bytes_sent += sent;
+        } else if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        } else {
+            return false;
+        }
+    }
+
+    if (device.out_offset == device.out.size()) {
+        device.out.clear();
+        device.out_offset = 0;
+    } else if (device.out_offset > FLEET_MAX_OUT_BYTES / 2) {
+        device.out.erase(device.out.begin(), device.out.begin() + device.out_offset);
+        device.out_offset = 0;
+    }
+
+    updateEpoll(device);
+    return true;
+}
+
+void FleetWorker::updateEpoll(Device& device) {
+    uint32_t wanted = EPOLLIN;
+    if (device.state == State::CONNECTING || !device.out.empty()) wanted |= EPOLLOUT;
+    if (wanted == device.epoll_events) return;
+
+    struct epoll_event event;
+    event.events = wanted;
+    event.data.u64 = &device - devices_.data();
+    epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, device.fd, &event);
+    device.epoll_events = wanted;
+}
+
+void FleetWorker::receive(Device& device, FleetClock::time_point now) {
+    char buffer[4096];
+
+    while (device.fd >= 0) {
+        ssize_t received = recv(device.fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+        if (received == 0 || (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+            disconnect(device, now, device.state != State::ONLINE);
+            return;
+        }
+        if (received < 0) return;
+
+        // Строки могут прийти разрезанными - как в SmartClient::receivingLoop()
+        for (ssize_t i = 0; i < received && device.fd >= 0; i++) {
+            if (buffer[i] != '\n' && device.line_length < sizeof(device.line) - 1) {
+                device.line[device.line_length++] = buffer[i];
+                continue;
+            }
+            device.line[device.line_length] = '\0';
+            device.line_length = 0;
+
+            uint32_t seq = 0;
+            if (device.state == State::HELLO) {
+                onHelloReply(device, device.line, now);
+            } else if (device.state == State::ONLINE && parseAck(device.line, seq)) {
+                releaseAcked(device, seq, now);
+            }
+        }
+    }
+}
+
+void FleetWorker::releaseAcked(Device& device, uint32_t acked, FleetClock::time_point now) {
+    bool released = false;
+    while (!device.inflight.empty() && seqLessOrEqual(device.inflight.front().seq, acked)) {
+        PendingFrame& frame = device.inflight.front();
+        if (frame.seq == acked && !frame.retransmitted) {
+            uint64_t rtt_us = elapsed_us(frame.sent_at, now);
+            updateRttEstimate(device.delivery, rtt_us / 1000.0);
+            stats_.ack_rtt.add(rtt_us);
+        }
+        device.inflight.pop_front();
+        if (device.resend_index > 0) device.resend_index--;
+        stats_.frames_acked++;
+        released = true;
+    }
+    if (released) {
+        pump(device, now);
+    }
+}
@@ -0,0 +1,206 @@
+#ifndef FLEET_MODULE_HPP
+#define FLEET_MODULE_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <netinet/in.h>
+
+#include "ethernet.hpp"
+#include "sensor.hpp"
+
+/*
+ * Нагрузочный генератор: тысячи виртуальных плат в одном процессе.
+ *
+ * Поведение устройства повторяет SmartClient + ButtonLedApp, но без двух
+ * потоков на соединение: все устройства потока - неблокирующие сокеты
+ * в одном epoll.
+ *   - HELLO / "OK codec=..." / ACK, кадры через buildFrame() (protocol.hpp);
+ *   - окно SMART_CLIENT_ACK_WINDOW, повтор неподтвержденных после переподключения;
+ *   - PING после SMART_CLIENT_HEARTBEAT_MS без данных;
+ *   - переподключение раз в APP_LOOP_PERIOD_MS, после APP_MAX_ATTEMPTS
+ *     неудач - ALERT на alert_hold_ms (вместо нажатия кнопки);
+ *   - пропал линк - ALERT; после возврата линка ждем еще alert_hold_ms
+ *     (оператор нажимает кнопку), только потом подключаемся;
+ *   - сроки устройств - в куче таймеров: поток будит только тех, чей срок
+ *     наступил, без обхода всех устройств.
+ *   - кадры датчика в формате sensor.hpp; без соединения кадр теряется,
+ *     как в sink из main().
+ */
+
+#define FLEET_CONNECT_TIMEOUT_MS 10000  // как SO_SNDTIMEO в SmartClient::start()
+#define FLEET_ALERT_HOLD_MS 5000       // от ALERT до нажатия кнопки (по умолчанию)
+#define FLEET_MAX_QUEUED_FRAMES 256     // очередь устройства, сверх - потеря
+#define FLEET_MAX_OUT_BYTES (64 * 1024) // не набираем новые кадры, пока сокет не разгребет
+
+using FleetClock = std::chrono::steady_clock;
+
+// Гистограмма задержек в микросекундах: интервалы 2^k, каждый делится на 8
+class LatencyHistogram {
+public:
+    void add(uint64_t us);
+    void merge(const LatencyHistogram& other);
+
+    uint64_t count() const { return count_; }
+    double maxMs() const { return max_us_ / 1000.0; }
+    double percentileMs(double percentile) const;
+
+private:
+    static constexpr int SUB_BUCKETS = 8;
+    static constexpr int BUCKETS = 40 * SUB_BUCKETS;
+
+    uint64_t buckets_[BUCKETS] = {};
+    uint64_t count_ = 0;
+    uint64_t max_us_ = 0;
+};
+
+struct FleetConfig {
+    std::string ip = "127.0.0.1";
+    int port = 8080;
+    unsigned int devices = 1000;
+    unsigned int threads = 4;
+    double rate_hz = 1.0;              // кадров в секунду на устройство
+    unsigned int samples_per_frame = 1;
+    unsigned int ramp_ms = 1000;       // первые подключения растянуты на это время
+    unsigned int flap_every_ms = 0;    // 0 - линк не пропадает
+    unsigned int flap_for_ms = 0;
+    unsigned int alert_hold_ms = FLEET_ALERT_HOLD_MS;
+    bool compress = true;
+    bool acks = true;
+};
+
+struct FleetStats {
+    uint64_t online = 0;
+    uint64_t connect_attempts = 0;
+    uint64_t connects = 0;
+    uint64_t connect_failures = 0;
+    uint64_t hello_timeouts = 0;       // сервер не ответил на HELLO - raw
+    uint64_t disconnects = 0;
+    uint64_t alerts = 0;
+    uint64_t link_flaps = 0;
+
+    uint64_t frames_sent = 0;
+    uint64_t frames_acked = 0;
+    uint64_t frames_retransmitted = 0;
+    uint64_t frames_dropped = 0;
+    uint64_t heartbeats = 0;
+    uint64_t bytes_sent = 0;
+
+    LatencyHistogram tcp_connect;      // connect() -> сокет готов
+    LatencyHistogram handshake;        // connect() -> ответ на HELLO
+    LatencyHistogram ack_rtt;          // кадр -> ACK (без повторов)
+
+    void merge(const FleetStats& other);
+};
+
+// Поток с epoll и частью устройств
+class FleetWorker {
+public:
+    FleetWorker(const FleetConfig& config, unsigned int first_device, unsigned int device_count);
+    ~FleetWorker();
+
+    bool start(FleetClock::time_point origin);
+    void stop();
+    FleetStats getStats() const;
+
+    FleetWorker(const FleetWorker&) = delete;
+    FleetWorker& operator=(const FleetWorker&) = delete;
+
+private:
+    enum class State { LINK_DOWN, IDLE, CONNECTING, HELLO, ONLINE };
+
+    struct PendingFrame {
+        std::vector<uint8_t> data;
+        uint32_t seq = 0;
+        FleetClock::time_point sent_at;
+        bool retransmitted = false;
+    };
+
+    struct Device {
+        unsigned int id = 0;
+        int fd = -1;
+        State state = State::IDLE;
+        int attempts = 0;
+        bool framed = false;
+        bool compressed = false;
+        bool acks = false;
+        bool legacy = false;                  // сервер не ответил на HELLO - больше не шлем
+        uint32_t epoll_events = 0;
+
+        FleetClock::time_point next_attempt;
+        FleetClock::time_point connect_started;
+        FleetClock::time_point deadline;      // CONNECTING / HELLO
+        FleetClock::time_point next_frame;
+        FleetClock::time_point last_send;
+        FleetClock::time_point next_flap;
+        FleetClock::time_point link_up_at;
+        FleetClock::time_point scheduled;     // срок единственной живой записи в timers_
+
+        std::deque<PendingFrame> queue;       // еще не отправлены
+        std::deque<PendingFrame> inflight;    // ждут ACK
+        size_t resend_index = 0;
+        uint32_t next_seq = 1;
+        uint32_t ping_counter = 0;
+        DeliveryStats delivery;
+
+        std::vector<uint8_t> out;
+        size_t out_offset = 0;
+        char line[128];
+        size_t line_length = 0;
+    };
+
+    FleetConfig config_;
+    unsigned int first_device_;
+    struct sockaddr_in server_addr_;
+    std::vector<Device> devices_;
+
+    int epoll_fd_ = -1;
+    int stop_fd_ = -1;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+
+    // Куча сроков (время, индекс устройства). Устаревшие записи не удаляются:
+    // при извлечении запись со временем, не равным Device::scheduled, пропускается
+    using Timer = std::pair<FleetClock::time_point, size_t>;
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> timers_;
+
+    LzCodec codec_;                           // у каждого потока свой (таблица внутри)
+    ImitationSensor sensor_;
+    std::vector<uint8_t> frame_buf_;
+    std::vector<uint8_t> wire_buf_;
+    std::chrono::nanoseconds frame_period_{0};
+
+    // Поток держит мьютекс, пока обрабатывает пачку событий
+    FleetStats stats_;
+    mutable std::mutex stats_mutex_;
+
+    void workerLoop();
+    FleetClock::time_point tick(Device& device, FleetClock::time_point now);
+    void schedule(size_t index, FleetClock::time_point when);
+    void handleEvent(Device& device, uint32_t events, FleetClock::time_point now);
+
+    void startConnect(Device& device, FleetClock::time_point now);
+    void onConnected(Device& device, FleetClock::time_point now);
+    void onHelloReply(Device& device, const char* reply, FleetClock::time_point now);
+    void goOnline(Device& device, FleetClock::time_point now);
+    void disconnect(Device& device, FleetClock::time_point now, bool failed_attempt);
+    void linkDown(Device& device, FleetClock::time_point now);
+
+    void produceFrame(Device& device, FleetClock::time_point now);
+    void pump(Device& device, FleetClock::time_point now);
+    void appendFrame(Device& device, const PendingFrame& frame, uint16_t flags);
+    bool flush(Device& device);
+    void updateEpoll(Device& device);
+    void receive(Device& device, FleetClock::time_point now);
+    void releaseAcked(Device& device, uint32_t acked, FleetClock::time_point now);
+};
+
+#endif
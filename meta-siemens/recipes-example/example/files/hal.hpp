@@ -0,0 +1,35 @@
+#ifndef HAL_MODULE_HPP
+#define HAL_MODULE_HPP
+
+/*
+ * Интерфейсы железа. Реальные реализации:
+ *   LedDevice    - SysfsLedController (/sys/class/leds)
+ *   ButtonDevice - SimpleButton (/sys/class/gpio)
+ *   LinkMonitor  - IfaceLinkMonitor (SIOCGIFFLAGS)
+ * Симуляция для сборки на x86 - в hal_sim.hpp.
+ */
+
+class LedDevice {
+public:
+    virtual ~LedDevice() = default;
+
+    virtual void switchON() = 0;
+    virtual void switchOFF() = 0;
+    virtual void blink(int hz) = 0;
+};
+
+class ButtonDevice {
+public:
+    virtual ~ButtonDevice() = default;
+
+    virtual bool isPressed() const = 0;
+};
+
+class LinkMonitor {
+public:
+    virtual ~LinkMonitor() = default;
+
+    virtual bool isLinkUp() = 0;
+};
+
+#endif
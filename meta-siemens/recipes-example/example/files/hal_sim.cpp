@@ -0,0 +1,104 @@
+#include <algorithm>
+
+#include "hal_sim.hpp"
+#include "memory_pool.hpp"
+
+SimLed::SimLed(const char* name) : name_(name) {}
+
+void SimLed::switchON() {
+    record(ON, 0);
+}
+
+void SimLed::switchOFF() {
+    record(OFF, 0);
+}
+
+void SimLed::blink(int hz) {
+    record(BLINK, hz);
+}
+
+void SimLed::record(led_statement_e state, int hz) {
+    {
+        HeapAllowedScope heap_allowed; // журнал симуляции, на плате его нет
+        std::lock_guard<std::mutex> lock(mutex_);
+        // Повторные ON/OFF из цикла main не меняют состояние
+        if (state == state_ && state != BLINK) return;
+        state_ = state;
+        events_.push_back({SimClock::now(), state, hz});
+    }
+    cv_.notify_all();
+}
+
+led_statement_e SimLed::state() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return state_;
+}
+
+std::vector<SimLed::Event> SimLed::events() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return events_;
+}
+
+bool SimLed::waitFor(led_statement_e state, SimClock::time_point since,
+                     std::chrono::milliseconds timeout, SimClock::time_point* when) {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    auto find = [&]() {
+        for (const auto& event : events_) {
+            if (event.time >= since && event.state == state) {
+                if (when) *when = event.time;
+                return true;
+            }
+        }
+        return false;
+    };
+
+    return cv_.wait_for(lock, timeout, find);
+}
+
+void SimButton::press(SimClock::time_point at, std::chrono::milliseconds hold) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    edges_.push_back({at, true});
+    edges_.push_back({at + hold, false});
+    std::sort(edges_.begin(), edges_.end(),
+              [](const Edge& a, const Edge& b) { return a.time < b.time; });
+}
+
+void SimButton::set(bool pressed) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    edges_.clear();
+    level_ = pressed;
+}
+
+bool SimButton::isPressed() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto now = SimClock::now();
+
+    bool pressed = level_;
+    for (const auto& edge : edges_) {
+        if (edge.time > now) break;
+        pressed = edge.pressed;
+    }
+    return pressed;
+}
+
+void SimLinkMonitor::flap(SimClock::time_point down_at, std::chrono::milliseconds down_for) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    flaps_.push_back({down_at, down_at + down_for});
+}
+
+void SimLinkMonitor::set(bool up) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    flaps_.clear();
+    up_ = up;
+}
+
+bool SimLinkMonitor::isLinkUp() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto now = SimClock::now();
+
+    for (const auto& flap : flaps_) {
+        if (now >= flap.down && now < flap.up) return false;
+    }
+    return up_;
+}
@@ -0,0 +1,88 @@
+#ifndef HAL_SIM_MODULE_HPP
+#define HAL_SIM_MODULE_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+#include "hal.hpp"
+#include "button-led.hpp"
+
+using SimClock = std::chrono::steady_clock;
+
+// Светодиод в памяти: каждое изменение записывается с меткой времени
+class SimLed : public LedDevice {
+public:
+    struct Event {
+        SimClock::time_point time;
+        led_statement_e state;
+        int hz;
+    };
+
+    explicit SimLed(const char* name);
+
+    void switchON() override;
+    void switchOFF() override;
+    void blink(int hz) override;
+
+    const char* name() const { return name_; }
+    led_statement_e state() const;
+    std::vector<Event> events() const;
+
+    // Ждет первое событие state не раньше since; false по таймауту
+    bool waitFor(led_statement_e state, SimClock::time_point since,
+                 std::chrono::milliseconds timeout, SimClock::time_point* when = nullptr);
+
+private:
+    const char* name_;
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    led_statement_e state_ = OFF;
+    std::vector<Event> events_;
+
+    void record(led_statement_e state, int hz);
+};
+
+/*
+ * Кнопка с расписанием фронтов. Уровень вычисляется по текущему времени
+ * при каждом isPressed(), поэтому фронт "происходит" ровно в заданный момент.
+ */
+class SimButton : public ButtonDevice {
+public:
+    void press(SimClock::time_point at, std::chrono::milliseconds hold);
+    void set(bool pressed);
+
+    bool isPressed() const override;
+
+private:
+    struct Edge {
+        SimClock::time_point time;
+        bool pressed;
+    };
+
+    mutable std::mutex mutex_;
+    std::vector<Edge> edges_;
+    bool level_ = false;
+};
+
+// Линк с расписанием пропаданий (link flap)
+class SimLinkMonitor : public LinkMonitor {
+public:
+    void flap(SimClock::time_point down_at, std::chrono::milliseconds down_for);
+    void set(bool up);
+
+    bool isLinkUp() override;
+
+private:
+    struct Flap {
+        SimClock::time_point down;
+        SimClock::time_point up;
+    };
+
+    std::mutex mutex_;
+    std::vector<Flap> flaps_;
+    bool up_ = true;
+};
+
+#endif
@@ -0,0 +1,194 @@
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <unistd.h>
+
+#include "memory_pool.hpp"
+
+static std::atomic<bool> g_steady_state{false};
+static std::atomic<bool> g_strict{false};
+static std::atomic<uint64_t> g_heap_allocations{0};
+static std::atomic<uint64_t> g_steady_allocations{0};
+static thread_local int t_heap_allowed = 0;
+
+// Пул с одним мьютексом на все потоки. synchronized_pool_resource держит
+// пулы на каждый поток и при выходе потока отдает их блоки в upstream, а
+// монотонная арена освобожденное не переиспользует: потоки SmartClient,
+// пересоздаваемые при каждом переподключении, выедали арену до bad_alloc.
+// Здесь освобожденные блоки остаются в общем пуле и уходят следующему потоку.
+class LockedPoolResource : public std::pmr::memory_resource {
+public:
+    LockedPoolResource(const std::pmr::pool_options& options, std::pmr::memory_resource* upstream)
+        : pool_(options, upstream) {}
+
+private:
+    std::mutex mutex_;
+    std::pmr::unsynchronized_pool_resource pool_;
+
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return pool_.allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* ptr, size_t bytes, size_t alignment) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pool_.deallocate(ptr, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+struct RuntimeArena {
+    std::unique_ptr<unsigned char[]> buffer;
+    std::pmr::monotonic_buffer_resource arena;
+    LockedPoolResource pool;
+
+    RuntimeArena(size_t arena_bytes, const std::pmr::pool_options& options)
+        : buffer(new unsigned char[arena_bytes]),
+          arena(buffer.get(), arena_bytes, std::pmr::null_memory_resource()),
+          pool(options, &arena) {}
+
+    ~RuntimeArena() {
+        if (std::pmr::get_default_resource() == &pool) {
+            std::pmr::set_default_resource(nullptr);
+        }
+    }
+};
+
+static std::unique_ptr<RuntimeArena> g_runtime_arena;
+
+bool RuntimeMemory::init(size_t arena_bytes, size_t largest_block_bytes) {
+#ifdef BUTTON_LED_NO_HEAP
+    if (g_runtime_arena) return true;
+
+    try {
+        std::pmr::pool_options options;
+        options.largest_required_pool_block = largest_block_bytes;
+        g_runtime_arena = std::make_unique<RuntimeArena>(arena_bytes, options);
+    } catch (const std::bad_alloc&) {
+        std::cerr << "[MEMORY] Failed to reserve " << arena_bytes << " bytes" << std::endl;
+        return false;
+    }
+
+    std::pmr::set_default_resource(&g_runtime_arena->pool);
+    std::cout << "[MEMORY] Reserved " << arena_bytes / 1024 << " KiB arena, pool blocks up to "
+              << largest_block_bytes / 1024 << " KiB" << std::endl;
+    return true;
+#else
+    (void)arena_bytes;
+    (void)largest_block_bytes;
+    return false;
+#endif
+}
+
+std::pmr::memory_resource* RuntimeMemory::resource() {
+    if (g_runtime_arena) {
+        return &g_runtime_arena->pool;
+    }
+    return std::pmr::new_delete_resource();
+}
+
+void RuntimeMemory::enterSteadyState() {
+    if (g_steady_state.exchange(true)) return;
+    std::cout << "[MEMORY] Entering steady state after " << g_heap_allocations
+              << " heap allocations" << std::endl;
+}
+
+bool RuntimeMemory::inSteadyState() {
+    return g_steady_state;
+}
+
+void RuntimeMemory::setStrict(bool strict) {
+    g_strict = strict;
+}
+
+bool RuntimeMemory::accountingEnabled() {
+#ifdef BUTTON_LED_ALLOC_ACCOUNTING
+    return true;
+#else
+    return false;
+#endif
+}
+
+uint64_t RuntimeMemory::heapAllocations() {
+    return g_heap_allocations;
+}
+
+uint64_t RuntimeMemory::steadyStateAllocations() {
+    return g_steady_allocations;
+}
+
+HeapAllowedScope::HeapAllowedScope() {
+    t_heap_allowed++;
+}
+
+HeapAllowedScope::~HeapAllowedScope() {
+    t_heap_allowed--;
+}
+
+#ifdef BUTTON_LED_ALLOC_ACCOUNTING
+
+static void account_allocation() {
+    g_heap_allocations.fetch_add(1, std::memory_order_relaxed);
+
+    if (!g_steady_state.load(std::memory_order_relaxed) || t_heap_allowed > 0) {
+        return;
+    }
+
+    g_steady_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (g_strict.load(std::memory_order_relaxed)) {
+        // Без iostream: он сам может выделять память
+        static const char message[] = "[MEMORY] Heap allocation in steady state, aborting\n";
+        ssize_t ignored = write(STDERR_FILENO, message, sizeof(message) - 1);
+        (void)ignored;
+        std::abort();
+    }
+}
+
+void* operator new(std::size_t size) {
+    account_allocation();
+    void* ptr = std::malloc(size ? size : 1);
+    if (ptr == nullptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    account_allocation();
+    return std::malloc(size ? size : 1);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    account_allocation();
+    // pmr::new_delete_resource передает и маленькие выравнивания (1, 2, 4)
+    size_t align = static_cast<size_t>(alignment);
+    if (align < sizeof(void*)) align = sizeof(void*);
+
+    void* ptr = nullptr;
+    if (posix_memalign(&ptr, align, size ? size : 1) != 0) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef MEMORY_POOL_HPP
+#define MEMORY_POOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+/*
+ * Память для рабочего цикла.
+ *
+ * init() один раз резервирует арену и строит поверх нее пул
+ * (unsynchronized_pool_resource под мьютексом -> monotonic_buffer_resource ->
+ * null_memory_resource). Освобожденные блоки возвращаются в пул и достаются
+ * любому потоку, поэтому пересоздание потоков арену не расходует.
+ * Все pmr-контейнеры рабочего цикла берут память из resource(); когда арена
+ * кончается, выделение бросает std::bad_alloc, а не уходит в malloc.
+ * Блоки крупнее largest_block_bytes идут мимо пула прямо в арену и обратно
+ * не возвращаются - largest_block_bytes должен покрывать самый большой кадр.
+ * Без init() (или при сборке без NO_HEAP_AFTER_INIT) resource() - обычная куча.
+ *
+ * При сборке с ALLOC_ACCOUNTING глобальные operator new/delete считаются.
+ * После enterSteadyState() каждое выделение из кучи считается нарушением,
+ * а в строгом режиме (setStrict(true)) процесс завершается через abort(),
+ * так что тест на стабильный режим падает при первом же malloc.
+ */
+class RuntimeMemory {
+public:
+    static bool init(size_t arena_bytes, size_t largest_block_bytes);
+    static std::pmr::memory_resource* resource();
+
+    static void enterSteadyState();
+    static bool inSteadyState();
+    static void setStrict(bool strict);
+
+    static bool accountingEnabled();
+    static uint64_t heapAllocations();
+    static uint64_t steadyStateAllocations();
+};
+
+// Разрешает выделения из кучи в текущем потоке (переподключение и т.п.)
+class HeapAllowedScope {
+public:
+    HeapAllowedScope();
+    ~HeapAllowedScope();
+
+    HeapAllowedScope(const HeapAllowedScope&) = delete;
+    HeapAllowedScope& operator=(const HeapAllowedScope&) = delete;
+};
+
+#endif
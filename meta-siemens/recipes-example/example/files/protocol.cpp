@@ -0,0 +1,98 @@
+#include <cstdlib>
+#include <cstring>
+
+#include "protocol.hpp"
+
+static void put_le(uint8_t* dst, uint32_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; i++) {
+        dst[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+static uint32_t get_le(const uint8_t* src, size_t bytes) {
+    uint32_t value = 0;
+    for (size_t i = 0; i < bytes; i++) {
+        value |= static_cast<uint32_t>(src[i]) << (8 * i);
+    }
+    return value;
+}
+
+void encodeFrameHeader(const FrameHeader& header, uint8_t* out) {
+    out[0] = header.magic;
+    out[1] = header.codec;
+    put_le(out + 2, header.flags, 2);
+    put_le(out + 4, header.raw_size, 4);
+    put_le(out + 8, header.wire_size, 4);
+    put_le(out + 12, header.seq, 4);
+}
+
+bool decodeFrameHeader(const uint8_t* in, FrameHeader& header) {
+    if (in[0] != PROTOCOL_FRAME_MAGIC) return false;
+
+    header.magic = in[0];
+    header.codec = in[1];
+    header.flags = static_cast<uint16_t>(get_le(in + 2, 2));
+    header.raw_size = get_le(in + 4, 4);
+    header.wire_size = get_le(in + 8, 4);
+    header.seq = get_le(in + 12, 4);
+    return true;
+}
+
+void buildFrame(PayloadCodec* codec, const uint8_t* data, size_t size, uint32_t seq, uint16_t flags,
+                std::vector<uint8_t>& out, FrameHeader& header) {
+    header = FrameHeader();
+    header.flags = flags;
+    header.raw_size = static_cast<uint32_t>(size);
+    header.seq = seq;
+
+    out.resize(PROTOCOL_FRAME_HEADER_SIZE);
+    if (codec) {
+        bool ok = codec->compress(data, size, out);
+        if (ok && out.size() - PROTOCOL_FRAME_HEADER_SIZE < size) {
+            header.codec = codec->id();
+        } else {
+            // Несжимаемые данные отправляем как есть
+            out.resize(PROTOCOL_FRAME_HEADER_SIZE);
+        }
+    }
+    if (header.codec == CODEC_NONE) {
+        out.insert(out.end(), data, data + size);
+    }
+
+    header.wire_size = static_cast<uint32_t>(out.size() - PROTOCOL_FRAME_HEADER_SIZE);
+    encodeFrameHeader(header, out.data());
+}
+
+std::string buildHello(const std::string& codecs, bool ack) {
+    return "HELLO " + std::to_string(PROTOCOL_VERSION) + " codecs=" + codecs +
+           (ack ? " ack=1" : "") + "\n";
+}
+
+bool parseHelloReply(const char* reply, std::string& codec_name, bool& ack) {
+    codec_name.clear();
+    ack = false;
+
+    if (strncmp(reply, "OK", 2) != 0) return false;
+
+    const char* codec = strstr(reply, "codec=");
+    if (codec == nullptr) return false;
+    codec += strlen("codec=");
+
+    size_t length = strcspn(codec, " \r\n");
+    codec_name.assign(codec, length);
+
+    const char* ack_option = strstr(reply, "ack=");
+    ack = ack_option != nullptr && ack_option[4] == '1';
+    return !codec_name.empty();
+}
+
+bool parseAck(const char* line, uint32_t& seq) {
+    if (strncmp(line, "ACK ", 4) != 0) return false;
+
+    char* end = nullptr;
+    unsigned long value = strtoul(line + 4, &end, 10);
+    if (end == line + 4) return false;
+
+    seq = static_cast<uint32_t>(value);
+    return true;
+}
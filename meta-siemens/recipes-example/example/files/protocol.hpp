@@ -0,0 +1,72 @@
+#ifndef PROTOCOL_MODULE_HPP
+#define PROTOCOL_MODULE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "compression.hpp"
+
+/*
+ * Протокол поверх TCP.
+ *
+ * Сразу после connect() клиент может предложить кодеки и подтверждения:
+ *   -> "HELLO 2 codecs=lz,none ack=1\n"
+ *   <- "OK codec=lz ack=1\n"
+ * Если сервер не ответил "OK" за PROTOCOL_HELLO_TIMEOUT_MS, соединение
+ * работает по-старому: данные уходят как есть, без заголовка. Такой сервер
+ * запоминается, и при переподключениях HELLO ему больше не отправляется.
+ * Для заранее известного старого сервера HELLO отключается совсем: без
+ * кодеков и с окном ACK 0 (BUTTON_LED_PROTOCOL=raw в button-led).
+ *
+ * В режиме с заголовками каждый кадр данных начинается с FrameHeader,
+ * heartbeat остается текстовой строкой "PING#<n>\n". Сервер различает
+ * их по первому байту (PROTOCOL_FRAME_MAGIC не встречается в тексте).
+ *
+ * Если сервер согласился на ack=1, он отвечает кумулятивными строками
+ * "ACK <seq>\n": все кадры с номером <= seq получены. Неподтвержденные
+ * кадры повторяются после переподключения с теми же номерами, так что
+ * дубликаты сервер отбрасывает по seq.
+ */
+
+#define PROTOCOL_VERSION 2
+#define PROTOCOL_FRAME_MAGIC 0xB1
+#define PROTOCOL_FRAME_HEADER_SIZE 16
+#define PROTOCOL_HELLO_TIMEOUT_MS 500
+
+#define FRAME_FLAG_RETRANSMIT 0x0001
+
+// Все поля little-endian
+struct FrameHeader {
+    uint8_t magic = PROTOCOL_FRAME_MAGIC;
+    uint8_t codec = CODEC_NONE;
+    uint16_t flags = 0;
+    uint32_t raw_size = 0;
+    uint32_t wire_size = 0;
+    uint32_t seq = 0;
+};
+
+void encodeFrameHeader(const FrameHeader& header, uint8_t* out);
+bool decodeFrameHeader(const uint8_t* in, FrameHeader& header);
+
+// Кадр целиком: заголовок + данные, сжатые codec, если так короче.
+// out перезаписывается; header - итоговый заголовок (для статистики).
+void buildFrame(PayloadCodec* codec, const uint8_t* data, size_t size, uint32_t seq, uint16_t flags,
+                std::vector<uint8_t>& out, FrameHeader& header);
+
+// Строка HELLO со списком кодеков через запятую
+std::string buildHello(const std::string& codecs, bool ack);
+
+// Разбор ответа сервера; codec_name пустой, если сервер не согласился
+bool parseHelloReply(const char* reply, std::string& codec_name, bool& ack);
+
+// "ACK <seq>"
+bool parseAck(const char* line, uint32_t& seq);
+
+// Сравнение номеров с учетом переполнения: a <= b
+inline bool seqLessOrEqual(uint32_t a, uint32_t b) {
+    return static_cast<int32_t>(a - b) <= 0;
+}
+
+#endif
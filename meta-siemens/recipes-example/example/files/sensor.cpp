@@ -0,0 +1,212 @@
+#include <iostream>
+#include <cstring>
+#include <ctime>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/timerfd.h>
+#include <sys/eventfd.h>
+
+#include "sensor.hpp"
+#include "trace.hpp"
+
+static constexpr size_t FRAME_HEADER_SIZE = 2;
+static constexpr size_t SAMPLE_HEADER_SIZE = 10;
+
+static uint64_t monotonic_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + ts.tv_nsec;
+}
+
+static void put_le(uint8_t* dst, uint64_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; i++) {
+        dst[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+size_t ImitationSensor::read(uint8_t* out, size_t max_size) {
+    static const uint8_t sample[] = {0x31,0x32,0x33,0x34,0x35,0x36,0x37,0x38,0x39};
+    size_t size = sizeof(sample) < max_size ? sizeof(sample) : max_size;
+    memcpy(out, sample, size);
+    return size;
+}
+
+SensorAcquisition::SensorAcquisition(SensorSource& source, unsigned int rate_hz, unsigned int samples_per_frame)
+    : source_(source), rate_hz_(rate_hz), samples_per_frame_(samples_per_frame) {
+    if (rate_hz_ < SENSOR_RATE_MIN_HZ) rate_hz_ = SENSOR_RATE_MIN_HZ;
+    if (rate_hz_ > SENSOR_RATE_MAX_HZ) rate_hz_ = SENSOR_RATE_MAX_HZ;
+    if (samples_per_frame_ == 0) samples_per_frame_ = 1;
+    if (samples_per_frame_ > 0xFFFF) samples_per_frame_ = 0xFFFF;
+
+    // Буфер кадра выделяется один раз
+    frame_.reserve(FRAME_HEADER_SIZE + samples_per_frame_ * (SAMPLE_HEADER_SIZE + SENSOR_SAMPLE_MAX_BYTES));
+    frame_.resize(FRAME_HEADER_SIZE);
+}
+
+SensorAcquisition::~SensorAcquisition() {
+    stop();
+}
+
+bool SensorAcquisition::start(FrameSink sink) {
+    if (running_) return true;
+
+    timer_fd_ = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+    if (timer_fd_ < 0) {
+        std::cerr << "[SENSOR] Failed to create timerfd: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    stop_fd_ = eventfd(0, EFD_CLOEXEC);
+    if (stop_fd_ < 0) {
+        std::cerr << "[SENSOR] Failed to create eventfd: " << strerror(errno) << std::endl;
+        closeFds();
+        return false;
+    }
+
+    const long period_ns = 1000000000L / rate_hz_;
+    struct itimerspec spec;
+    memset(&spec, 0, sizeof(spec));
+    spec.it_interval.tv_sec = period_ns / 1000000000L;
+    spec.it_interval.tv_nsec = period_ns % 1000000000L;
+    spec.it_value = spec.it_interval;
+
+    if (timerfd_settime(timer_fd_, 0, &spec, nullptr) < 0) {
+        std::cerr << "[SENSOR] Failed to arm timerfd: " << strerror(errno) << std::endl;
+        closeFds();
+        return false;
+    }
+
+    sink_ = std::move(sink);
+    frame_.resize(FRAME_HEADER_SIZE);
+    frame_samples_ = 0;
+    running_ = true;
+    thread_ = std::thread(&SensorAcquisition::acquisitionLoop, this);
+
+    std::cout << "[SENSOR] Source '" << source_.name() << "' started at " << rate_hz_
+              << " Hz, " << samples_per_frame_ << " samples per frame" << std::endl;
+    return true;
+}
+
+void SensorAcquisition::stop() {
+    if (!running_) return;
+
+    running_ = false;
+    uint64_t one = 1;
+    if (write(stop_fd_, &one, sizeof(one)) < 0) {
+        std::cerr << "[SENSOR] Failed to wake acquisition thread: " << strerror(errno) << std::endl;
+    }
+
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    closeFds();
+
+    std::cout << "[SENSOR] Source '" << source_.name() << "' stopped" << std::endl;
+}
+
+void SensorAcquisition::closeFds() {
+    if (timer_fd_ >= 0) {
+        ::close(timer_fd_);
+        timer_fd_ = -1;
+    }
+    if (stop_fd_ >= 0) {
+        ::close(stop_fd_);
+        stop_fd_ = -1;
+    }
+}
+
+bool SensorAcquisition::isRunning() const {
+    return running_;
+}
+
+unsigned int SensorAcquisition::getRateHz() const {
+    return rate_hz_;
+}
+
+unsigned int SensorAcquisition::getSamplesPerFrame() const {
+    return samples_per_frame_;
+}
+
+SensorStats SensorAcquisition::getStats() const {
+    SensorStats stats;
+    stats.samples = samples_;
+    stats.frames = frames_;
+    stats.dropped_frames = dropped_frames_;
+    stats.missed_ticks = missed_ticks_;
+    return stats;
+}
+
+void SensorAcquisition::acquisitionLoop() {
+    Tracer::setThreadName("sensor");
+
+    struct pollfd fds[2];
+    fds[0].fd = timer_fd_;
+    fds[0].events = POLLIN;
+    fds[1].fd = stop_fd_;
+    fds[1].events = POLLIN;
+
+    while (running_) {
+        int result = poll(fds, 2, -1);
+        if (result < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "[SENSOR] poll failed: " << strerror(errno) << std::endl;
+            break;
+        }
+
+        if (fds[1].revents & POLLIN) break;
+
+        if (fds[0].revents & POLLIN) {
+            uint64_t expirations = 0;
+            if (read(timer_fd_, &expirations, sizeof(expirations)) != sizeof(expirations)) {
+                continue;
+            }
+            // Пропущенные тики не догоняем - отсчет берется один раз
+            if (expirations > 1) {
+                missed_ticks_ += expirations - 1;
+            }
+            acquire();
+        }
+    }
+}
+
+void SensorAcquisition::acquire() {
+    // Событие кадра начинается с первого отсчета
+    if (frame_samples_ == 0) {
+        frame_trace_id_ = TRACE_NEW_ID();
+        TRACE_SCOPE("sensor_sample", frame_trace_id_, TRACE_FLOW_START);
+    }
+
+    size_t offset = frame_.size();
+    frame_.resize(offset + SAMPLE_HEADER_SIZE + SENSOR_SAMPLE_MAX_BYTES);
+
+    // Метка времени ставится в момент чтения датчика
+    uint64_t timestamp = monotonic_ns();
+    size_t size = source_.read(frame_.data() + offset + SAMPLE_HEADER_SIZE, SENSOR_SAMPLE_MAX_BYTES);
+    if (size == 0) {
+        frame_.resize(offset);
+        return;
+    }
+
+    put_le(frame_.data() + offset, timestamp, 8);
+    put_le(frame_.data() + offset + 8, size, 2);
+    frame_.resize(offset + SAMPLE_HEADER_SIZE + size);
+    samples_++;
+
+    if (++frame_samples_ >= samples_per_frame_) {
+        flushFrame();
+    }
+}
+
+void SensorAcquisition::flushFrame() {
+    TRACE_SCOPE("sensor_frame", frame_trace_id_, TRACE_FLOW_STEP);
+    put_le(frame_.data(), frame_samples_, 2);
+
+    if (sink_ && sink_(frame_, frame_trace_id_)) {
+        frames_++;
+    } else {
+        dropped_frames_++;
+    }
+
+    frame_.resize(FRAME_HEADER_SIZE);
+    frame_samples_ = 0;
+}
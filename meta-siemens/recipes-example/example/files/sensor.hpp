@@ -0,0 +1,93 @@
+#ifndef SENSOR_MODULE_HPP
+#define SENSOR_MODULE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#define SENSOR_RATE_MIN_HZ 1
+#define SENSOR_RATE_MAX_HZ 10000
+#define SENSOR_SAMPLE_MAX_BYTES 64
+
+// Источник данных: одно чтение = один отсчет
+class SensorSource {
+public:
+    virtual ~SensorSource() = default;
+
+    // Возвращает количество записанных байт (0 - отсчета нет)
+    virtual size_t read(uint8_t* out, size_t max_size) = 0;
+    virtual const char* name() const = 0;
+};
+
+// Имитация датчика (то, что раньше формировалось в main)
+class ImitationSensor : public SensorSource {
+public:
+    size_t read(uint8_t* out, size_t max_size) override;
+    const char* name() const override { return "imitation"; }
+};
+
+struct SensorStats {
+    uint64_t samples = 0;
+    uint64_t frames = 0;
+    uint64_t dropped_frames = 0;
+    uint64_t missed_ticks = 0;   // переполнения timerfd
+};
+
+/*
+ * Сбор отсчетов по собственному timerfd, независимо от цикла main().
+ * Каждый отсчет получает метку CLOCK_MONOTONIC в момент чтения,
+ * отсчеты собираются в кадр и передаются в sink (очередь транспорта).
+ *
+ * Формат кадра (little-endian):
+ *   u16 sample_count
+ *   sample_count x { u64 timestamp_ns, u16 size, size байт данных }
+ */
+class SensorAcquisition {
+public:
+    // trace_id - id события для трассировки (trace.hpp), 0 если выключена
+    using FrameSink = std::function<bool(const std::vector<uint8_t>&, uint64_t trace_id)>;
+
+    SensorAcquisition(SensorSource& source, unsigned int rate_hz, unsigned int samples_per_frame);
+    ~SensorAcquisition();
+
+    bool start(FrameSink sink);
+    void stop();
+    bool isRunning() const;
+
+    unsigned int getRateHz() const;
+    unsigned int getSamplesPerFrame() const;
+    SensorStats getStats() const;
+
+    SensorAcquisition(const SensorAcquisition&) = delete;
+    SensorAcquisition& operator=(const SensorAcquisition&) = delete;
+
+private:
+    SensorSource& source_;
+    unsigned int rate_hz_;
+    unsigned int samples_per_frame_;
+
+    int timer_fd_ = -1;
+    int stop_fd_ = -1;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    FrameSink sink_;
+
+    std::vector<uint8_t> frame_;
+    unsigned int frame_samples_ = 0;
+    uint64_t frame_trace_id_ = 0;
+
+    std::atomic<uint64_t> samples_{0};
+    std::atomic<uint64_t> frames_{0};
+    std::atomic<uint64_t> dropped_frames_{0};
+    std::atomic<uint64_t> missed_ticks_{0};
+
+    void acquisitionLoop();
+    void acquire();
+    void flushFrame();
+    void closeFds();
+};
+
+#endif
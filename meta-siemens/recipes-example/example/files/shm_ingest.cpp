@@ -0,0 +1,372 @@
+#include <iostream>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#include "shm_ingest.hpp"
+#include "trace.hpp"
+
+// Метки epoll: тип в старших 32 битах, номер издателя - в младших
+static constexpr uint64_t TAG_STOP = 0;
+static constexpr uint64_t TAG_LISTEN = 1;
+static constexpr uint64_t TAG_CONN = 2;
+static constexpr uint64_t TAG_DOORBELL = 3;
+
+static uint64_t make_tag(uint64_t kind, size_t slot) {
+    return (kind << 32) | slot;
+}
+
+ShmIngest::ShmIngest(const std::string& socket_path) : socket_path_(socket_path) {}
+
+ShmIngest::~ShmIngest() {
+    stop();
+}
+
+bool ShmIngest::createListenSocket() {
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (socket_path_.size() >= sizeof(addr.sun_path)) {
+        std::cerr << "[INGEST] Socket path too long: " << socket_path_ << std::endl;
+        return false;
+    }
+    strncpy(addr.sun_path, socket_path_.c_str(), sizeof(addr.sun_path) - 1);
+
+    // Каталог обычно создает systemd (RuntimeDirectory=button-led)
+    std::string dir = socket_path_.substr(0, socket_path_.rfind('/'));
+    if (!dir.empty() && mkdir(dir.c_str(), 0755) < 0 && errno != EEXIST) {
+        std::cerr << "[INGEST] Failed to create " << dir << ": " << strerror(errno) << std::endl;
+    }
+
+    listen_fd_ = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+    if (listen_fd_ < 0) {
+        std::cerr << "[INGEST] Failed to create socket: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    unlink(socket_path_.c_str()); // остался от прошлого запуска
+    if (bind(listen_fd_, (struct sockaddr*)&addr, sizeof(addr)) < 0 ||
+        listen(listen_fd_, SHM_INGEST_MAX_PUBLISHERS) < 0) {
+        std::cerr << "[INGEST] Failed to listen on " << socket_path_ << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    // Публиковать могут root и группа владельца
+    chmod(socket_path_.c_str(), 0660);
+    return true;
+}
+
+bool ShmIngest::start(FrameSink sink) {
+    if (running_) return true;
+
+    if (!createListenSocket()) {
+        closeFds();
+        return false;
+    }
+
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    stop_fd_ = eventfd(0, EFD_CLOEXEC);
+    if (epoll_fd_ < 0 || stop_fd_ < 0) {
+        std::cerr << "[INGEST] Failed to create epoll/eventfd: " << strerror(errno) << std::endl;
+        closeFds();
+        return false;
+    }
+
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.u64 = make_tag(TAG_STOP, 0);
+    epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, stop_fd_, &event);
+    event.data.u64 = make_tag(TAG_LISTEN, 0);
+    epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, listen_fd_, &event);
+
+    sink_ = std::move(sink);
+    running_ = true;
+    thread_ = std::thread(&ShmIngest::ingestLoop, this);
+
+    std::cout << "[INGEST] Listening on " << socket_path_ << std::endl;
+    return true;
+}
+
+void ShmIngest::stop() {
+    if (!running_) return;
+
+    running_ = false;
+    uint64_t one = 1;
+    if (write(stop_fd_, &one, sizeof(one)) < 0) {
+        std::cerr << "[INGEST] Failed to wake ingest thread: " << strerror(errno) << std::endl;
+    }
+
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+
+    for (size_t slot = 0; slot < SHM_INGEST_MAX_PUBLISHERS; slot++) {
+        releasePublisher(slot);
+    }
+    closeFds();
+    unlink(socket_path_.c_str());
+
+    std::cout << "[INGEST] Stopped" << std::endl;
+}
+
+void ShmIngest::closeFds() {
+    if (listen_fd_ >= 0) {
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+    }
+    if (epoll_fd_ >= 0) {
+        ::close(epoll_fd_);
+        epoll_fd_ = -1;
+    }
+    if (stop_fd_ >= 0) {
+        ::close(stop_fd_);
+        stop_fd_ = -1;
+    }
+}
+
+bool ShmIngest::isRunning() const {
+    return running_;
+}
+
+ShmIngestStats ShmIngest::getStats() const {
+    ShmIngestStats stats;
+    stats.publishers = publisher_count_;
+    stats.frames = frames_;
+    stats.bytes = bytes_;
+    stats.dropped_frames = dropped_frames_;
+    stats.ring_full = ring_full_;
+    stats.protocol_errors = protocol_errors_;
+    return stats;
+}
+
+void ShmIngest::acceptPublisher() {
+    int conn_fd = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+    if (conn_fd < 0) return;
+
+    size_t slot = 0;
+    while (slot < SHM_INGEST_MAX_PUBLISHERS && publishers_[slot].ring != nullptr) slot++;
+    if (slot == SHM_INGEST_MAX_PUBLISHERS) {
+        std::cerr << "[INGEST] Too many publishers, connection refused" << std::endl;
+        ::close(conn_fd);
+        return;
+    }
+
+    struct ucred cred;
+    socklen_t cred_len = sizeof(cred);
+    memset(&cred, 0, sizeof(cred));
+    getsockopt(conn_fd, SOL_SOCKET, SO_PEERCRED, &cred, &cred_len);
+
+    int mem_fd = memfd_create("button-led-ingest", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    int doorbell_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    void* map = MAP_FAILED;
+
+    if (mem_fd >= 0 && doorbell_fd >= 0 && ftruncate(mem_fd, SHM_RING_FILE_BYTES) == 0 &&
+        fcntl(mem_fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) == 0) {
+        map = mmap(nullptr, SHM_RING_FILE_BYTES, PROT_READ | PROT_WRITE, MAP_SHARED, mem_fd, 0);
+    }
+
+    if (map == MAP_FAILED) {
+        std::cerr << "[INGEST] Failed to create ring: " << strerror(errno) << std::endl;
+        if (mem_fd >= 0) ::close(mem_fd);
+        if (doorbell_fd >= 0) ::close(doorbell_fd);
+        ::close(conn_fd);
+        return;
+    }
+
+    ShmRingHeader* ring = new (map) ShmRingHeader;
+    ring->magic = SHM_RING_MAGIC;
+    ring->version = SHM_RING_VERSION;
+    ring->capacity = SHM_RING_DATA_BYTES;
+    ring->head.store(0);
+    ring->tail.store(0);
+    ring->consumer_waiting.store(0);
+    ring->dropped.store(0);
+
+    int fds[2] = {mem_fd, doorbell_fd};
+    bool sent = shmSendFds(conn_fd, fds, 2);
+    ::close(mem_fd); // у издателя своя копия, у нас - отображение
+
+    if (!sent) {
+        std::cerr << "[INGEST] Failed to pass ring to pid " << cred.pid << std::endl;
+        munmap(map, SHM_RING_FILE_BYTES);
+        ::close(doorbell_fd);
+        ::close(conn_fd);
+        return;
+    }
+
+    Publisher& publisher = publishers_[slot];
+    publisher.conn_fd = conn_fd;
+    publisher.doorbell_fd = doorbell_fd;
+    publisher.ring = ring;
+    publisher.pid = cred.pid;
+    publisher.head = 0;
+    publisher.dropped_seen = 0;
+
+    struct epoll_event event;
+    event.events = EPOLLIN | EPOLLRDHUP;
+    event.data.u64 = make_tag(TAG_CONN, slot);
+    epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, conn_fd, &event);
+    event.events = EPOLLIN;
+    event.data.u64 = make_tag(TAG_DOORBELL, slot);
+    epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, doorbell_fd, &event);
+
+    publisher_count_++;
+    std::cout << "[INGEST] Publisher pid " << cred.pid << " attached (slot " << slot << ")" << std::endl;
+}
+
+void ShmIngest::releasePublisher(size_t slot) {
+    Publisher& publisher = publishers_[slot];
+    if (publisher.ring == nullptr) return;
+
+    std::cout << "[INGEST] Publisher pid " << publisher.pid << " detached (slot " << slot << ")" << std::endl;
+
+    // close() сам убирает дескрипторы из epoll
+    ::close(publisher.conn_fd);
+    ::close(publisher.doorbell_fd);
+    munmap(publisher.ring, SHM_RING_FILE_BYTES);
+    publisher = Publisher();
+    publisher_count_--;
+}
+
+bool ShmIngest::drain(Publisher& publisher) {
+    ShmRingHeader* ring = publisher.ring;
+    const uint64_t capacity = SHM_RING_DATA_BYTES; // не доверяем полю в общей памяти
+    const uint8_t* data = shmRingData(ring);
+
+    uint64_t dropped = ring->dropped.load(std::memory_order_relaxed);
+    // Счетчик пишет издатель: назад он идти не может, иначе ring_full_ улетит
+    if (dropped > publisher.dropped_seen) {
+        ring_full_ += dropped - publisher.dropped_seen;
+        publisher.dropped_seen = dropped;
+    }
+
+    // head из общей памяти не читаем: издатель мог его переписать
+    uint64_t head = publisher.head;
+    const uint64_t tail = ring->tail.load(std::memory_order_acquire);
+    if (tail - head > capacity) return false;
+
+    while (head != tail) {
+        uint64_t offset = head % capacity;
+        uint64_t to_end = capacity - offset;
+
+        uint32_t length = 0;
+        uint32_t flags = 0;
+        memcpy(&length, data + offset, 4);
+        memcpy(&flags, data + offset + 4, 4);
+
+        if (flags & SHM_RECORD_PAD) {
+            if (length != to_end - SHM_RECORD_HEADER_SIZE || to_end > tail - head) return false;
+            head += to_end;
+            publisher.head = head;
+            continue;
+        }
+
+        uint64_t span = shmRecordSpan(length);
+        if (length == 0 || length > SHM_RECORD_MAX_BYTES || span > to_end || span > tail - head) {
+            return false;
+        }
+
+        uint64_t trace_id = TRACE_NEW_ID();
+        TRACE_SCOPE("shm_ingest", trace_id, TRACE_FLOW_START);
+        if (sink_ && sink_(data + offset + SHM_RECORD_HEADER_SIZE, length, trace_id)) {
+            frames_++;
+            bytes_ += length;
+            if (dropping_) {
+                dropping_ = false;
+                std::cout << "[INGEST] Uplink accepts frames again, " << dropped_frames_
+                          << " dropped so far" << std::endl;
+            }
+        } else {
+            dropped_frames_++;
+            // Без вывода на каждый кадр: только начало серии потерь
+            if (!dropping_) {
+                dropping_ = true;
+                std::cerr << "[INGEST] Uplink not accepting frames, dropping publisher frames" << std::endl;
+            }
+        }
+
+        head += span;
+        publisher.head = head;
+        // Освобождаем место сразу, не дожидаясь конца пачки
+        ring->head.store(head, std::memory_order_release);
+    }
+    return true;
+}
+
+void ShmIngest::ingestLoop() {
+    Tracer::setThreadName("shm-ingest");
+
+    struct epoll_event events[2 * SHM_INGEST_MAX_PUBLISHERS + 2];
+
+    while (running_) {
+        // Перед сном просим звонок, потом перепроверяем кольца
+        bool pending = false;
+        for (Publisher& publisher : publishers_) {
+            if (publisher.ring) publisher.ring->consumer_waiting.store(1, std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        for (Publisher& publisher : publishers_) {
+            if (publisher.ring && publisher.ring->tail.load(std::memory_order_relaxed) !=
+                                  publisher.ring->head.load(std::memory_order_relaxed)) {
+                pending = true;
+            }
+        }
+
+        int count = epoll_wait(epoll_fd_, events, sizeof(events) / sizeof(events[0]), pending ? 0 : -1);
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "[INGEST] epoll_wait failed: " << strerror(errno) << std::endl;
+            break;
+        }
+
+        bool accept_pending = false;
+        bool hangup[SHM_INGEST_MAX_PUBLISHERS] = {};
+
+        for (int i = 0; i < count; i++) {
+            uint64_t kind = events[i].data.u64 >> 32;
+            size_t slot = static_cast<size_t>(events[i].data.u64 & 0xFFFFFFFF);
+
+            if (kind == TAG_STOP) {
+                return;
+            } else if (kind == TAG_LISTEN) {
+                accept_pending = true;
+            } else if (kind == TAG_CONN) {
+                // Издатель ничего не пишет в сокет: любое событие - отключение
+                hangup[slot] = true;
+            } else if (kind == TAG_DOORBELL) {
+                uint64_t value;
+                if (read(publishers_[slot].doorbell_fd, &value, sizeof(value)) < 0 && errno != EAGAIN) {
+                    hangup[slot] = true;
+                }
+            }
+        }
+
+        for (size_t slot = 0; slot < SHM_INGEST_MAX_PUBLISHERS; slot++) {
+            Publisher& publisher = publishers_[slot];
+            if (publisher.ring == nullptr) continue;
+
+            publisher.ring->consumer_waiting.store(0, std::memory_order_relaxed);
+            // Дочитываем и при отключении - кадры уже в общей памяти
+            if (!drain(publisher)) {
+                std::cerr << "[INGEST] Corrupted ring from pid " << publisher.pid << std::endl;
+                protocol_errors_++;
+                hangup[slot] = true;
+            }
+            if (hangup[slot]) {
+                releasePublisher(slot);
+            }
+        }
+
+        if (accept_pending) {
+            acceptPublisher();
+        }
+    }
+}
@@ -0,0 +1,81 @@
+#ifndef SHM_INGEST_HPP
+#define SHM_INGEST_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+#include <sys/types.h>
+
+#include "shm_ring.hpp"
+
+struct ShmIngestStats {
+    uint64_t publishers = 0;       // подключены сейчас
+    uint64_t frames = 0;           // приняты sink
+    uint64_t bytes = 0;
+    uint64_t dropped_frames = 0;   // sink отказал (нет соединения)
+    uint64_t ring_full = 0;        // издатели отказались от кадров: кольцо было полным
+    uint64_t protocol_errors = 0;  // испорченные кольца, издатель отключен
+};
+
+/*
+ * Прием кадров от локальных процессов (shm_ring.hpp, клиент - shm_publisher.hpp).
+ * Один поток на epoll: unix-сокет для новых издателей, их eventfd и сокеты.
+ * Кадр передается в sink прямо из общей памяти; единственная копия -
+ * в очередь SmartClient.
+ */
+class ShmIngest {
+public:
+    using FrameSink = std::function<bool(const uint8_t* data, size_t size, uint64_t trace_id)>;
+
+    explicit ShmIngest(const std::string& socket_path = SHM_INGEST_SOCKET_PATH);
+    ~ShmIngest();
+
+    bool start(FrameSink sink);
+    void stop();
+    bool isRunning() const;
+    ShmIngestStats getStats() const;
+
+    ShmIngest(const ShmIngest&) = delete;
+    ShmIngest& operator=(const ShmIngest&) = delete;
+
+private:
+    struct Publisher {
+        int conn_fd = -1;
+        int doorbell_fd = -1;
+        ShmRingHeader* ring = nullptr;
+        pid_t pid = 0;
+        uint64_t head = 0;           // позиция чтения; в общую память только пишется
+        uint64_t dropped_seen = 0;
+    };
+
+    std::string socket_path_;
+    int listen_fd_ = -1;
+    int epoll_fd_ = -1;
+    int stop_fd_ = -1;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    FrameSink sink_;
+
+    // Только поток приема
+    Publisher publishers_[SHM_INGEST_MAX_PUBLISHERS];
+    bool dropping_ = false;        // sink отказывает - в лог только начало и конец серии
+
+    std::atomic<uint64_t> publisher_count_{0};
+    std::atomic<uint64_t> frames_{0};
+    std::atomic<uint64_t> bytes_{0};
+    std::atomic<uint64_t> dropped_frames_{0};
+    std::atomic<uint64_t> ring_full_{0};
+    std::atomic<uint64_t> protocol_errors_{0};
+
+    void ingestLoop();
+    void acceptPublisher();
+    void releasePublisher(size_t slot);
+    bool drain(Publisher& publisher);
+    bool createListenSocket();
+    void closeFds();
+};
+
+#endif
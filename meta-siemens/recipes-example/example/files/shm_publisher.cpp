@@ -0,0 +1,172 @@
+#include <iostream>
+#include <cstring>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#include "shm_publisher.hpp"
+
+ShmPublisher::ShmPublisher() {}
+
+ShmPublisher::~ShmPublisher() {
+    close();
+}
+
+bool ShmPublisher::connect(const std::string& path) {
+    close();
+
+    socket_fd_ = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (socket_fd_ < 0) {
+        std::cerr << "[PUBLISHER] Failed to create socket: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+    if (::connect(socket_fd_, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        std::cerr << "[PUBLISHER] Failed to connect to " << path << ": " << strerror(errno) << std::endl;
+        close();
+        return false;
+    }
+
+    int fds[2] = {-1, -1};
+    if (!shmReceiveFds(socket_fd_, fds, 2)) {
+        std::cerr << "[PUBLISHER] Ingest refused connection (no free slot?)" << std::endl;
+        close();
+        return false;
+    }
+    doorbell_fd_ = fds[1];
+
+    struct stat st;
+    if (fstat(fds[0], &st) < 0 || static_cast<size_t>(st.st_size) != SHM_RING_FILE_BYTES) {
+        std::cerr << "[PUBLISHER] Unexpected ring size" << std::endl;
+        ::close(fds[0]);
+        close();
+        return false;
+    }
+
+    void* map = mmap(nullptr, SHM_RING_FILE_BYTES, PROT_READ | PROT_WRITE, MAP_SHARED, fds[0], 0);
+    ::close(fds[0]); // отображение держит memfd само
+    if (map == MAP_FAILED) {
+        std::cerr << "[PUBLISHER] mmap failed: " << strerror(errno) << std::endl;
+        close();
+        return false;
+    }
+
+    ring_ = static_cast<ShmRingHeader*>(map);
+    if (ring_->magic != SHM_RING_MAGIC || ring_->version != SHM_RING_VERSION ||
+        ring_->capacity != SHM_RING_DATA_BYTES) {
+        std::cerr << "[PUBLISHER] Ring version mismatch" << std::endl;
+        close();
+        return false;
+    }
+
+    std::cout << "[PUBLISHER] Connected to " << path << std::endl;
+    return true;
+}
+
+void ShmPublisher::close() {
+    if (ring_ != nullptr) {
+        munmap(ring_, SHM_RING_FILE_BYTES);
+        ring_ = nullptr;
+    }
+    if (doorbell_fd_ >= 0) {
+        ::close(doorbell_fd_);
+        doorbell_fd_ = -1;
+    }
+    if (socket_fd_ >= 0) {
+        ::close(socket_fd_);
+        socket_fd_ = -1;
+    }
+    reserved_ = nullptr;
+    reserved_size_ = 0;
+}
+
+bool ShmPublisher::isConnected() const {
+    if (ring_ == nullptr) return false;
+
+    struct pollfd pfd;
+    pfd.fd = socket_fd_;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    if (poll(&pfd, 1, 0) < 0) return false;
+    return (pfd.revents & (POLLHUP | POLLERR | POLLIN)) == 0;
+}
+
+uint8_t* ShmPublisher::reserve(size_t size) {
+    if (ring_ == nullptr || size == 0 || size > SHM_RECORD_MAX_BYTES) return nullptr;
+
+    const uint64_t capacity = SHM_RING_DATA_BYTES;
+    const uint64_t span = shmRecordSpan(static_cast<uint32_t>(size));
+    uint64_t tail = ring_->tail.load(std::memory_order_relaxed);
+    const uint64_t head = ring_->head.load(std::memory_order_acquire);
+
+    uint64_t offset = tail % capacity;
+    uint64_t to_end = capacity - offset;
+    uint64_t needed = span + (to_end < span ? to_end : 0);
+
+    if (tail + needed - head > capacity) {
+        ring_full_++;   // издатель может повторить: потерей это еще не считается
+        return nullptr;
+    }
+
+    uint8_t* data = shmRingData(ring_);
+    if (to_end < span) {
+        // Запись не переходит через конец: хвост занимает заполнитель
+        uint32_t pad_length = static_cast<uint32_t>(to_end - SHM_RECORD_HEADER_SIZE);
+        uint32_t pad_flags = SHM_RECORD_PAD;
+        memcpy(data + offset, &pad_length, 4);
+        memcpy(data + offset + 4, &pad_flags, 4);
+        tail += to_end;
+        offset = 0;
+    }
+
+    reserved_tail_ = tail;
+    reserved_ = data + offset;
+    reserved_size_ = size;
+    return reserved_ + SHM_RECORD_HEADER_SIZE;
+}
+
+bool ShmPublisher::commit(size_t size) {
+    if (reserved_ == nullptr || size == 0 || size > reserved_size_) return false;
+
+    uint32_t length = static_cast<uint32_t>(size);
+    uint32_t flags = 0;
+    memcpy(reserved_, &length, 4);
+    memcpy(reserved_ + 4, &flags, 4);
+    reserved_ = nullptr;
+
+    ring_->tail.store(reserved_tail_ + shmRecordSpan(length), std::memory_order_release);
+
+    // Пара к fence потребителя: либо он увидит новый tail, либо мы - его флаг
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (ring_->consumer_waiting.load(std::memory_order_relaxed) != 0 &&
+        ring_->consumer_waiting.exchange(0) != 0) {
+        uint64_t one = 1;
+        if (write(doorbell_fd_, &one, sizeof(one)) < 0) {
+            std::cerr << "[PUBLISHER] Doorbell failed: " << strerror(errno) << std::endl;
+        }
+    }
+    return true;
+}
+
+bool ShmPublisher::publish(const uint8_t* data, size_t size) {
+    uint8_t* out = reserve(size);
+    if (out == nullptr) return false;
+    memcpy(out, data, size);
+    return commit(size);
+}
+
+void ShmPublisher::dropFrame() {
+    if (ring_) ring_->dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t ShmPublisher::getDropped() const {
+    return ring_ ? ring_->dropped.load(std::memory_order_relaxed) : 0;
+}
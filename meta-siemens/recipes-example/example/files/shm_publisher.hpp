@@ -0,0 +1,62 @@
+#ifndef SHM_PUBLISHER_HPP
+#define SHM_PUBLISHER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "shm_ring.hpp"
+
+/*
+ * Клиентская библиотека для локальных процессов: кадры уходят в общее
+ * TCP-соединение button-led через кольцо в общей памяти (shm_ring.hpp).
+ *
+ *   ShmPublisher publisher;
+ *   publisher.connect();
+ *   uint8_t* out = publisher.reserve(size);   // пишем прямо в общую память
+ *   ...
+ *   publisher.commit(size);
+ *
+ * Не потокобезопасен: один ShmPublisher - один поток-издатель.
+ */
+class ShmPublisher {
+private:
+    int socket_fd_ = -1;
+    int doorbell_fd_ = -1;
+    ShmRingHeader* ring_ = nullptr;
+
+    uint8_t* reserved_ = nullptr;
+    size_t reserved_size_ = 0;
+    uint64_t reserved_tail_ = 0;   // tail после записи-заполнителя
+    uint64_t ring_full_ = 0;       // неудачные reserve(): попытки, не кадры
+
+public:
+    ShmPublisher();
+    ~ShmPublisher();
+
+    bool connect(const std::string& path = SHM_INGEST_SOCKET_PATH);
+    void close();
+    // false, если button-led закрыл соединение
+    bool isConnected() const;
+
+    // nullptr - кольцо заполнено или size > SHM_RECORD_MAX_BYTES
+    uint8_t* reserve(size_t size);
+    // size <= размера из reserve()
+    bool commit(size_t size);
+    // reserve() + memcpy + commit()
+    bool publish(const uint8_t* data, size_t size);
+
+    // Издатель отказался от кадра (кольцо так и не освободилось): кадр
+    // считается потерянным один раз, button-led видит его в ring full
+    void dropFrame();
+
+    // Сколько кадров отброшено через dropFrame()
+    uint64_t getDropped() const;
+    // Сколько раз reserve() застал кольцо полным (с повторами)
+    uint64_t getRingFull() const { return ring_full_; }
+
+    ShmPublisher(const ShmPublisher&) = delete;
+    ShmPublisher& operator=(const ShmPublisher&) = delete;
+};
+
+#endif
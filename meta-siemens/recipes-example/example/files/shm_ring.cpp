@@ -0,0 +1,76 @@
+#include <cstring>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "shm_ring.hpp"
+
+#define SHM_MAX_PASSED_FDS 4
+
+bool shmSendFds(int socket_fd, const int* fds, int count) {
+    if (count <= 0 || count > SHM_MAX_PASSED_FDS) return false;
+
+    char tag = 'R';
+    struct iovec iov;
+    iov.iov_base = &tag;
+    iov.iov_len = sizeof(tag);
+
+    alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(int) * SHM_MAX_PASSED_FDS)];
+    memset(control, 0, sizeof(control));
+
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = CMSG_SPACE(sizeof(int) * count);
+
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int) * count);
+    memcpy(CMSG_DATA(cmsg), fds, sizeof(int) * count);
+
+    return sendmsg(socket_fd, &msg, MSG_NOSIGNAL) == static_cast<ssize_t>(sizeof(tag));
+}
+
+bool shmReceiveFds(int socket_fd, int* fds, int count) {
+    if (count <= 0 || count > SHM_MAX_PASSED_FDS) return false;
+
+    char tag = 0;
+    struct iovec iov;
+    iov.iov_base = &tag;
+    iov.iov_len = sizeof(tag);
+
+    alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(int) * SHM_MAX_PASSED_FDS)];
+    memset(control, 0, sizeof(control));
+
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    if (recvmsg(socket_fd, &msg, MSG_CMSG_CLOEXEC) != static_cast<ssize_t>(sizeof(tag)) || tag != 'R') {
+        return false;
+    }
+
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    if (cmsg == nullptr || cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS) {
+        return false;
+    }
+
+    int received[SHM_MAX_PASSED_FDS];
+    size_t received_count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+    if (received_count > SHM_MAX_PASSED_FDS) received_count = SHM_MAX_PASSED_FDS;
+    memcpy(received, CMSG_DATA(cmsg), sizeof(int) * received_count);
+
+    // Чужое количество дескрипторов - закрываем, чтобы не утекли
+    if (received_count != static_cast<size_t>(count)) {
+        for (size_t i = 0; i < received_count; i++) close(received[i]);
+        return false;
+    }
+
+    memcpy(fds, received, sizeof(int) * count);
+    return true;
+}
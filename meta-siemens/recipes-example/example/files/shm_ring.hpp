@@ -0,0 +1,67 @@
+#ifndef SHM_RING_HPP
+#define SHM_RING_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * Общая память между button-led и локальными процессами-издателями.
+ *
+ * Издатель подключается к unix-сокету SHM_INGEST_SOCKET_PATH (SOCK_SEQPACKET)
+ * и получает через SCM_RIGHTS два дескриптора:
+ *   memfd   - кольцо ShmRingHeader + SHM_RING_DATA_BYTES данных
+ *             (запечатано F_SEAL_SHRINK/F_SEAL_GROW - издатель не может
+ *             уменьшить файл и уронить button-led по SIGBUS);
+ *   eventfd - "звонок": издатель пишет в него, только если потребитель
+ *             выставил consumer_waiting и уснул в epoll.
+ * Соединение держится все время работы издателя; его закрытие - сигнал
+ * потребителю освободить кольцо.
+ *
+ * Кольцо однопоточное с каждой стороны (один издатель - одно кольцо).
+ * head/tail - байтовые смещения, растут монотонно (по модулю capacity).
+ * Запись: u32 length, u32 flags, length байт, выравнивание до 8.
+ * Запись не переходит через конец буфера: вместо этого в хвост кладется
+ * запись SHM_RECORD_PAD, и данные начинаются с нуля.
+ */
+
+#define SHM_INGEST_SOCKET_PATH "/run/button-led/ingest.sock"
+#define SHM_INGEST_MAX_PUBLISHERS 8
+
+#define SHM_RING_MAGIC 0x53484D31 // "SHM1"
+#define SHM_RING_VERSION 1
+#define SHM_RING_DATA_BYTES (256 * 1024)
+#define SHM_RECORD_HEADER_SIZE 8
+#define SHM_RECORD_MAX_BYTES (64 * 1024) // как SMART_CLIENT_MAX_FRAME_BYTES
+#define SHM_RECORD_PAD 0x1
+
+struct ShmRingHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t capacity;                        // байт данных, кратно 8
+
+    alignas(64) std::atomic<uint64_t> head;   // пишет только потребитель (свою копию он не читает обратно)
+    alignas(64) std::atomic<uint64_t> tail;   // пишет только издатель
+    std::atomic<uint32_t> consumer_waiting;   // 1 - нужен звонок в eventfd
+    std::atomic<uint64_t> dropped;            // кадры, от которых издатель отказался (кольцо полное)
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "shared memory ring needs lock-free 64-bit atomics");
+
+#define SHM_RING_DATA_OFFSET ((sizeof(ShmRingHeader) + 63) & ~static_cast<size_t>(63))
+#define SHM_RING_FILE_BYTES (SHM_RING_DATA_OFFSET + SHM_RING_DATA_BYTES)
+
+inline uint64_t shmRecordSpan(uint32_t length) {
+    return (SHM_RECORD_HEADER_SIZE + static_cast<uint64_t>(length) + 7) & ~static_cast<uint64_t>(7);
+}
+
+inline uint8_t* shmRingData(ShmRingHeader* header) {
+    return reinterpret_cast<uint8_t*>(header) + SHM_RING_DATA_OFFSET;
+}
+
+// Передача дескрипторов по unix-сокету (SCM_RIGHTS)
+bool shmSendFds(int socket_fd, const int* fds, int count);
+bool shmReceiveFds(int socket_fd, int* fds, int count);
+
+#endif
@@ -0,0 +1,180 @@
+/*
+ * test-codec: сжатие -> распаковка для LzCodec/NullCodec и кадров buildFrame().
+ *
+ * Входы подобраны под ветки формата: пустой и короче MIN_MATCH, кадр
+ * датчика, литералы длиннее 15 байт, длинные и перекрывающиеся совпадения,
+ * несжимаемые данные, границы размера хэш-таблицы. Один кодек сжимает
+ * входы подряд (большой, потом маленький) - так ловятся устаревшие ячейки
+ * таблицы. Испорченные данные decompress() должна отвергать.
+ *
+ * Код возврата 1, если не прошла хоть одна проверка (запускается из ctest).
+ */
+
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "compression.hpp"
+#include "protocol.hpp"
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& what) {
+    if (!condition) {
+        std::cerr << "[TEST] FAILED: " << what << std::endl;
+        failures++;
+    }
+}
+
+static void roundTrip(PayloadCodec& codec, const std::vector<uint8_t>& input, const std::string& name) {
+    // Результат дописывается в конец out - проверяем и это
+    std::vector<uint8_t> compressed = {0xAA, 0xBB};
+    check(codec.compress(input.data(), input.size(), compressed), name + ": compress");
+    check(compressed[0] == 0xAA && compressed[1] == 0xBB, name + ": compress kept prefix");
+
+    std::vector<uint8_t> restored = {0xCC};
+    bool ok = codec.decompress(compressed.data() + 2, compressed.size() - 2, input.size(), restored);
+    check(ok, name + ": decompress");
+    check(restored.size() == input.size() + 1 && restored[0] == 0xCC &&
+          std::equal(input.begin(), input.end(), restored.begin() + 1), name + ": data mismatch");
+
+    // Лишний или недостающий байт raw_size - ошибка, а не мусор в out
+    if (!input.empty()) {
+        std::vector<uint8_t> out;
+        check(!codec.decompress(compressed.data() + 2, compressed.size() - 2, input.size() - 1, out),
+              name + ": accepted short raw_size");
+        // Обрезаем до половины: последний пустой токен лишним не считается
+        out.clear();
+        check(!codec.decompress(compressed.data() + 2, (compressed.size() - 2) / 2, input.size(), out),
+              name + ": accepted truncated input");
+    }
+}
+
+static std::vector<uint8_t> sensorFrame(unsigned int samples) {
+    // Формат sensor.hpp: u16 count, { u64 timestamp, u16 size, данные }
+    static const uint8_t sample[] = {0x31,0x32,0x33,0x34,0x35,0x36,0x37,0x38,0x39};
+    std::vector<uint8_t> frame = {static_cast<uint8_t>(samples), static_cast<uint8_t>(samples >> 8)};
+    uint64_t timestamp = 1234567890123ull;
+    for (unsigned int i = 0; i < samples; i++) {
+        timestamp += 1000000 + (i * 7919) % 5000;
+        for (int b = 0; b < 8; b++) frame.push_back(static_cast<uint8_t>(timestamp >> (8 * b)));
+        frame.push_back(sizeof(sample));
+        frame.push_back(0);
+        frame.insert(frame.end(), sample, sample + sizeof(sample));
+    }
+    return frame;
+}
+
+int main() {
+    std::mt19937 random(42);
+    auto randomBytes = [&random](size_t size) {
+        std::vector<uint8_t> data(size);
+        for (auto& byte : data) byte = static_cast<uint8_t>(random());
+        return data;
+    };
+
+    std::vector<std::pair<std::string, std::vector<uint8_t>>> inputs;
+    inputs.push_back({"empty", {}});
+    inputs.push_back({"1 byte", {0x42}});
+    inputs.push_back({"3 bytes", {1, 2, 3}});
+    inputs.push_back({"4 equal bytes", {7, 7, 7, 7}});
+    inputs.push_back({"sensor frame x1", sensorFrame(1)});
+    inputs.push_back({"sensor frame x64", sensorFrame(64)});
+    inputs.push_back({"random 17", randomBytes(17)});
+    inputs.push_back({"random 4096", randomBytes(4096)});
+    inputs.push_back({"zeros 70000", std::vector<uint8_t>(70000, 0)});
+
+    std::vector<uint8_t> pattern;
+    for (int i = 0; i < 1000; i++) pattern.push_back("abc"[i % 3]);
+    inputs.push_back({"period 3 (overlapping match)", pattern});
+
+    std::vector<uint8_t> text;
+    const std::string line = "PING#12345 temperature=21.5 humidity=40\n";
+    while (text.size() < 3000) text.insert(text.end(), line.begin(), line.end());
+    inputs.push_back({"repeated text", text});
+
+    // Литералы, совпадение, снова литералы - длины около границ 15 и 255+15
+    std::vector<uint8_t> mixed = randomBytes(300);
+    mixed.insert(mixed.end(), mixed.begin(), mixed.begin() + 270);
+    auto tail = randomBytes(14);
+    mixed.insert(mixed.end(), tail.begin(), tail.end());
+    inputs.push_back({"literals + match + literals", mixed});
+
+    // Размеры около шагов хэш-таблицы
+    for (size_t size : {63, 64, 65, 4095, 4096, 4097}) {
+        auto data = randomBytes(size / 2);
+        data.insert(data.end(), data.begin(), data.begin() + (size - data.size()));
+        inputs.push_back({"half repeated " + std::to_string(size), data});
+    }
+
+    LzCodec lz;
+    NullCodec none;
+    for (const auto& input : inputs) {
+        roundTrip(lz, input.second, "lz " + input.first);
+        roundTrip(none, input.second, "none " + input.first);
+    }
+
+    // Тот же кодек: после большого входа маленький не должен видеть старые позиции
+    for (int round = 0; round < 50; round++) {
+        auto big = randomBytes(5000);
+        big.insert(big.end(), big.begin(), big.begin() + 2000);
+        roundTrip(lz, big, "lz reuse big");
+        roundTrip(lz, sensorFrame(1 + round % 3), "lz reuse small");
+    }
+
+    // Несжимаемые данные не выходят за LZ_COMPRESS_BOUND (под него резервирует SmartClient)
+    for (const auto& input : inputs) {
+        std::vector<uint8_t> out;
+        lz.compress(input.second.data(), input.second.size(), out);
+        check(out.size() <= LZ_COMPRESS_BOUND(input.second.size()), "lz bound " + input.first);
+    }
+    for (size_t size : {15, 16, 270, 271, 65536}) {
+        auto data = randomBytes(size);
+        std::vector<uint8_t> out;
+        lz.compress(data.data(), data.size(), out);
+        check(out.size() <= LZ_COMPRESS_BOUND(size), "lz bound random " + std::to_string(size));
+    }
+
+    std::vector<uint8_t> compressed;
+    lz.compress(text.data(), text.size(), compressed);
+    check(compressed.size() < text.size() / 4, "lz does not compress repeated text");
+
+    // Испорченный поток: смещение за начало вывода
+    std::vector<uint8_t> out;
+    const uint8_t bad_offset[] = {0x10, 'a', 0x05, 0x00};
+    check(!lz.decompress(bad_offset, sizeof(bad_offset), 9, out), "lz accepted offset beyond output");
+
+    // Кадры целиком: заголовок + (сжатые) данные
+    std::vector<uint8_t> wire;
+    for (const auto& input : inputs) {
+        for (PayloadCodec* codec : {static_cast<PayloadCodec*>(&lz), static_cast<PayloadCodec*>(nullptr)}) {
+            FrameHeader header;
+            buildFrame(codec, input.second.data(), input.second.size(), 77, FRAME_FLAG_RETRANSMIT, wire, header);
+
+            FrameHeader decoded;
+            const std::string name = "frame " + input.first + (codec ? " lz" : " none");
+            check(wire.size() >= PROTOCOL_FRAME_HEADER_SIZE && decodeFrameHeader(wire.data(), decoded),
+                  name + ": header");
+            check(decoded.seq == 77 && decoded.flags == FRAME_FLAG_RETRANSMIT &&
+                  decoded.raw_size == input.second.size() &&
+                  decoded.wire_size == wire.size() - PROTOCOL_FRAME_HEADER_SIZE, name + ": header fields");
+
+            std::vector<uint8_t> payload;
+            PayloadCodec& decoder = decoded.codec == CODEC_LZ ? static_cast<PayloadCodec&>(lz)
+                                                               : static_cast<PayloadCodec&>(none);
+            check(decoder.decompress(wire.data() + PROTOCOL_FRAME_HEADER_SIZE, decoded.wire_size,
+                                     decoded.raw_size, payload) && payload == input.second,
+                  name + ": payload");
+        }
+    }
+
+    if (failures) {
+        std::cerr << "[TEST] " << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "[TEST] codec round trip: " << inputs.size() << " inputs OK" << std::endl;
+    return 0;
+}
@@ -0,0 +1,369 @@
+/*
+ * test-failover: ни один принятый sendData() кадр не теряется, когда сервер
+ * умирает посреди потока.
+ *
+ * Коллектор на loopback говорит по protocol.hpp (HELLO, кадры, "ACK <seq>").
+ * Основной коллектор подтверждает первые TEST_ACKED_FRAMES кадров, следующие
+ * TEST_LOST_FRAMES принимает без ACK и "теряет", после чего рвет соединение.
+ *   --mode standby    второй коллектор - горячий резерв (setupStandby), клиент
+ *                     переключается на него; основной перестает принимать
+ *                     подключения
+ *   --mode reconnect  без резерва: как ButtonLedApp, клиент перезапускается
+ *                     к тому же коллектору и повторяет неподтвержденные
+ *   --mode double     как standby, но резерв тоже умирает после
+ *                     TEST_BACKUP_ACKED_FRAMES кадров, а основной продолжает
+ *                     принимать подключения: два failover подряд, второй -
+ *                     обратно на основной
+ *   --mode bogus-ack  как reconnect, но на первый потерянный кадр коллектор
+ *                     отвечает ACK далеко за последним отправленным номером;
+ *                     клиент должен его отвергнуть и все равно повторить кадры
+ *   --io classic|uring  путь ввода-вывода клиента
+ * Объединение принятого обоими коллекторами должно покрыть все кадры,
+ * а номера seq - идти без пропусков.
+ *
+ * Код возврата 1, если не прошла хоть одна проверка (запускается из ctest).
+ */
+
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include "ethernet.hpp"
+#include "hal.hpp"
+#include "protocol.hpp"
+
+#define TEST_FRAMES 400
+#define TEST_FRAME_INTERVAL_MS 2
+#define TEST_ACKED_FRAMES 150
+#define TEST_LOST_FRAMES 10          // меньше SMART_CLIENT_ACK_WINDOW
+#define TEST_BACKUP_ACKED_FRAMES 60
+#define TEST_TIMEOUT_MS 10000
+#define TEST_MAX_CONNECTIONS 4
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& what) {
+    if (!condition) {
+        std::cerr << "[TEST] FAILED: " << what << std::endl;
+        failures++;
+    }
+}
+
+class NullLed : public LedDevice {
+public:
+    void switchON() override {}
+    void switchOFF() override {}
+    void blink(int) override {}
+};
+
+class LinkUp : public LinkMonitor {
+public:
+    bool isLinkUp() override { return true; }
+};
+
+// Коллектор protocol.hpp: HELLO -> "OK codec=none ack=1", кадр -> "ACK <seq>"
+class FramedCollector {
+public:
+    // kill_after > 0: после стольких подтвержденных кадров следующие
+    // TEST_LOST_FRAMES теряются, затем соединение рвется
+    // bogus_ack: на первый потерянный кадр - ACK за пределами отправленного
+    FramedCollector(const char* name, unsigned int kill_after, bool close_listener, bool bogus_ack = false)
+        : name_(name), kill_after_(kill_after), close_listener_(close_listener), bogus_ack_(bogus_ack) {}
+
+    bool start() {
+        listen_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+        if (listen_fd_ < 0) return false;
+
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t len = sizeof(addr);
+        if (bind(listen_fd_, (struct sockaddr*)&addr, sizeof(addr)) < 0 || listen(listen_fd_, 4) < 0 ||
+            getsockname(listen_fd_, (struct sockaddr*)&addr, &len) < 0) {
+            return false;
+        }
+        port_ = ntohs(addr.sin_port);
+
+        running_ = true;
+        thread_ = std::thread(&FramedCollector::loop, this);
+        return true;
+    }
+
+    void stop() {
+        running_ = false;
+        if (thread_.joinable()) thread_.join();
+        for (Connection& conn : connections_) {
+            if (conn.fd >= 0) ::close(conn.fd);
+        }
+        if (listen_fd_ >= 0) ::close(listen_fd_);
+    }
+
+    int port() const { return port_; }
+    bool killed() const { return killed_; }
+    unsigned int hellos() const { return hellos_; }
+
+    // Принятые кадры: номера seq и индексы из данных ("frame-%05d")
+    void received(std::set<uint32_t>& seqs, std::set<int>& frames) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        seqs.insert(seqs_.begin(), seqs_.end());
+        frames.insert(frames_.begin(), frames_.end());
+    }
+
+private:
+    struct Connection {
+        int fd = -1;
+        std::vector<uint8_t> buffer;
+    };
+
+    const char* name_;
+    unsigned int kill_after_;
+    bool close_listener_;
+    bool bogus_ack_;
+    int listen_fd_ = -1;
+    int port_ = 0;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> killed_{false};
+    std::atomic<unsigned int> hellos_{0};
+    std::thread thread_;
+    Connection connections_[TEST_MAX_CONNECTIONS];
+    unsigned int acked_ = 0;
+    unsigned int lost_ = 0;
+
+    std::mutex mutex_;
+    std::set<uint32_t> seqs_;
+    std::set<int> frames_;
+
+    void closeConnection(Connection& conn) {
+        ::close(conn.fd);
+        conn.fd = -1;
+        conn.buffer.clear();
+    }
+
+    void loop() {
+        while (running_) {
+            struct pollfd fds[TEST_MAX_CONNECTIONS + 1];
+            int count = 0;
+            if (listen_fd_ >= 0) fds[count++] = {listen_fd_, POLLIN, 0};
+            for (Connection& conn : connections_) {
+                if (conn.fd >= 0) fds[count++] = {conn.fd, POLLIN, 0};
+            }
+            if (poll(fds, count, 20) <= 0) continue;
+
+            if (listen_fd_ >= 0 && (fds[0].revents & POLLIN)) {
+                int fd = accept(listen_fd_, nullptr, nullptr);
+                for (Connection& conn : connections_) {
+                    if (fd >= 0 && conn.fd < 0) {
+                        conn.fd = fd;
+                        fd = -1;
+                    }
+                }
+                if (fd >= 0) ::close(fd);
+            }
+
+            for (Connection& conn : connections_) {
+                if (conn.fd < 0) continue;
+                uint8_t chunk[4096];
+                ssize_t received = recv(conn.fd, chunk, sizeof(chunk), MSG_DONTWAIT);
+                if (received == 0 || (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+                    closeConnection(conn);
+                    continue;
+                }
+                if (received > 0) {
+                    conn.buffer.insert(conn.buffer.end(), chunk, chunk + received);
+                    parse(conn);
+                }
+            }
+        }
+    }
+
+    void parse(Connection& conn) {
+        size_t offset = 0;
+        while (conn.fd >= 0 && offset < conn.buffer.size()) {
+            const uint8_t* data = conn.buffer.data() + offset;
+            const size_t available = conn.buffer.size() - offset;
+
+            if (data[0] != PROTOCOL_FRAME_MAGIC) {
+                // Текстовая строка: HELLO или PING
+                const void* eol = memchr(data, '\n', available);
+                if (eol == nullptr) break;
+                const size_t length = static_cast<const uint8_t*>(eol) - data + 1;
+                if (strncmp(reinterpret_cast<const char*>(data), "HELLO", 5) == 0) {
+                    const char reply[] = "OK codec=none ack=1\n";
+                    send(conn.fd, reply, sizeof(reply) - 1, MSG_NOSIGNAL);
+                    hellos_++;
+                }
+                offset += length;
+                continue;
+            }
+
+            FrameHeader header;
+            if (available < PROTOCOL_FRAME_HEADER_SIZE) break;
+            if (!decodeFrameHeader(data, header)) {
+                std::cerr << "[TEST] " << name_ << ": bad frame header" << std::endl;
+                closeConnection(conn);
+                return;
+            }
+            if (available < PROTOCOL_FRAME_HEADER_SIZE + header.wire_size) break;
+            onFrame(conn, header, data + PROTOCOL_FRAME_HEADER_SIZE);
+            offset += PROTOCOL_FRAME_HEADER_SIZE + header.wire_size;
+        }
+        if (conn.fd >= 0) conn.buffer.erase(conn.buffer.begin(), conn.buffer.begin() + offset);
+    }
+
+    void onFrame(Connection& conn, const FrameHeader& header, const uint8_t* payload) {
+        if (kill_after_ > 0 && !killed_ && acked_ >= kill_after_) {
+            // Сервер умирает: кадры дошли до него, но не подтверждены и пропали
+            if (++lost_ < TEST_LOST_FRAMES) {
+                if (bogus_ack_ && lost_ == 1) {
+                    char ack[32];
+                    int length = snprintf(ack, sizeof(ack), "ACK %u\n", header.seq + 100000);
+                    send(conn.fd, ack, length, MSG_NOSIGNAL);
+                }
+                return;
+            }
+            std::cout << "[TEST] " << name_ << ": dropping connection after " << acked_
+                      << " acked and " << lost_ << " lost frames" << std::endl;
+            killed_ = true;
+            closeConnection(conn);
+            if (close_listener_) {
+                ::close(listen_fd_);
+                listen_fd_ = -1;
+            }
+            return;
+        }
+
+        int index = -1;
+        if (header.codec == CODEC_NONE) {
+            std::string text(reinterpret_cast<const char*>(payload), header.wire_size);
+            sscanf(text.c_str(), "frame-%d", &index);
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            seqs_.insert(header.seq);
+            if (index >= 0) frames_.insert(index);
+        }
+        acked_++;
+
+        char ack[32];
+        int length = snprintf(ack, sizeof(ack), "ACK %u\n", header.seq);
+        send(conn.fd, ack, length, MSG_NOSIGNAL);
+    }
+};
+
+static bool waitFor(const std::function<bool()>& condition) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(TEST_TIMEOUT_MS);
+    while (std::chrono::steady_clock::now() < deadline) {
+        if (condition()) return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return condition();
+}
+
+int main(int argc, char* argv[]) {
+    std::string mode = "standby";
+    bool uring = false;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--mode") == 0) mode = argv[i + 1];
+        else if (strcmp(argv[i], "--io") == 0) uring = strcmp(argv[i + 1], "uring") == 0;
+    }
+    const bool twice = mode == "double";
+    const bool standby = mode == "standby" || twice;
+    const bool bogus_ack = mode == "bogus-ack";
+    if (!standby && !bogus_ack && mode != "reconnect") {
+        std::cerr << "[TEST] Unknown mode: " << mode << std::endl;
+        return 2;
+    }
+
+    FramedCollector primary("primary", TEST_ACKED_FRAMES, standby && !twice, bogus_ack);
+    FramedCollector backup("standby", twice ? TEST_BACKUP_ACKED_FRAMES : 0, false);
+    check(primary.start(), "primary collector start");
+    if (standby) check(backup.start(), "standby collector start");
+
+    NullLed led1, led2;
+    LinkUp link;
+    SmartClient client;
+    client.setupLed(&led1, &led2);
+    client.setupLinkMonitor(&link);
+    if (standby) client.setupStandby("127.0.0.1", backup.port());
+    if (uring) client.setIoBackend(IoBackend::URING);
+
+    check(client.start("127.0.0.1", primary.port()), "client start");
+    std::cout << "[TEST] mode " << mode
+              << ", io " << client.getIoBackendName() << std::endl;
+    if (standby) {
+        check(waitFor([&backup]() { return backup.hellos() > 0; }), "standby connection not established");
+    }
+
+    // Кадр больше SMART_CLIENT_MAX_FRAME_BYTES не ставится в очередь, а считается потерей
+    std::vector<uint8_t> oversized(SMART_CLIENT_MAX_FRAME_BYTES + 1, 'x');
+    check(!client.sendData(oversized) && client.getDeliveryStats().dropped == 1, "oversized frame accepted");
+
+    // Как ButtonLedApp + датчик: кадр без соединения теряется, обрыв - перезапуск
+    std::set<int> accepted;
+    for (int i = 0; i < TEST_FRAMES; i++) {
+        if (!standby && !client.isConnected()) {
+            client.stop();
+            client.start("127.0.0.1", primary.port());
+        }
+
+        char text[32];
+        int length = snprintf(text, sizeof(text), "frame-%05d", i);
+        std::vector<uint8_t> frame(text, text + length);
+        if (client.sendData(frame)) accepted.insert(i);
+        std::this_thread::sleep_for(std::chrono::milliseconds(TEST_FRAME_INTERVAL_MS));
+    }
+
+    std::set<uint32_t> seqs;
+    std::set<int> frames;
+    auto collect = [&]() {
+        seqs.clear();
+        frames.clear();
+        primary.received(seqs, frames);
+        backup.received(seqs, frames);
+    };
+    bool complete = waitFor([&]() {
+        collect();
+        return std::includes(frames.begin(), frames.end(), accepted.begin(), accepted.end());
+    });
+
+    DeliveryStats delivery = client.getDeliveryStats();
+    client.stop();
+    primary.stop();
+    if (standby) backup.stop();
+
+    check(primary.killed(), "primary was never killed");
+    check(accepted.size() > TEST_ACKED_FRAMES + TEST_LOST_FRAMES, "too few frames accepted by sendData");
+    check(complete, "frames lost: accepted " + std::to_string(accepted.size()) + ", received " +
+                    std::to_string(frames.size()));
+    check(!seqs.empty() && *seqs.begin() == 1 && *seqs.rbegin() == seqs.size(),
+          "seq union has gaps: " + std::to_string(seqs.size()) + " numbers up to " +
+          std::to_string(seqs.empty() ? 0 : *seqs.rbegin()));
+    check(delivery.retransmitted >= TEST_LOST_FRAMES, "lost frames were not retransmitted");
+    if (standby) check(delivery.failovers >= (twice ? 2u : 1u), "failovers: " + std::to_string(delivery.failovers));
+    if (twice) check(backup.killed(), "standby was never killed");
+
+    if (failures) {
+        std::cerr << "[TEST] " << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "[TEST] " << mode << ": " << accepted.size()
+              << " frames delivered, seq 1.." << seqs.size() << ", " << delivery.retransmitted
+              << " retransmitted" << std::endl;
+    return 0;
+}
@@ -0,0 +1,57 @@
+/*
+ * test-memory-pool: арена RuntimeMemory переживает пересоздание потоков.
+ *
+ * SmartClient при каждом переподключении заводит новые потоки отправки и
+ * приема, и те берут кадры из RuntimeMemory::resource(). Пул не должен
+ * оставлять за завершившимся потоком память, которую арена уже не вернет:
+ * иначе после нескольких сотен переподключений выделение бросает bad_alloc.
+ * Здесь тысячи коротких потоков гоняют через арену очередь кадров.
+ *
+ * Код возврата 1, если арена кончилась (запускается из ctest).
+ */
+
+#include <iostream>
+#include <deque>
+#include <memory_resource>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include "memory_pool.hpp"
+
+#define TEST_ARENA_BYTES (1024 * 1024)
+#define TEST_POOL_BLOCK_BYTES (64 * 1024)
+#define TEST_THREADS 2000
+#define TEST_FRAMES_PER_THREAD 64
+
+int main() {
+    if (!RuntimeMemory::init(TEST_ARENA_BYTES, TEST_POOL_BLOCK_BYTES)) {
+        std::cout << "[TEST] built without NO_HEAP_AFTER_INIT, nothing to check" << std::endl;
+        return 0;
+    }
+
+    bool exhausted = false;
+    int round = 0;
+    for (; round < TEST_THREADS && !exhausted; round++) {
+        // Как поток отправки: очередь кадров разного размера из арены
+        std::thread worker([&exhausted, round]() {
+            try {
+                std::pmr::deque<std::pmr::vector<uint8_t>> queue(RuntimeMemory::resource());
+                for (int i = 0; i < TEST_FRAMES_PER_THREAD; i++) {
+                    queue.emplace_back(32 + (round * 7 + i * 131) % 4096, static_cast<uint8_t>(i));
+                    if (queue.size() > 16) queue.pop_front();
+                }
+            } catch (const std::bad_alloc&) {
+                exhausted = true;
+            }
+        });
+        worker.join();
+    }
+
+    if (exhausted) {
+        std::cerr << "[TEST] FAILED: arena exhausted after " << round << " threads" << std::endl;
+        return 1;
+    }
+    std::cout << "[TEST] arena survived " << round << " threads" << std::endl;
+    return 0;
+}
@@ -0,0 +1,243 @@
+/*
+ * test-shm-ingest: издатель -> кольцо в общей памяти -> ShmIngest -> SmartClient -> TCP.
+ *
+ * Коллектор на loopback принимает поток без HELLO (клиент без кодеков и ACK)
+ * и сравнивает его с опубликованными кадрами. Кадры, опубликованные до
+ * подключения клиента, должны попасть в счетчик потерь ShmIngest, а не
+ * пропасть молча.
+ *
+ * Код возврата 1, если не прошла хоть одна проверка (запускается из ctest).
+ */
+
+#include <iostream>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include "ethernet.hpp"
+#include "hal.hpp"
+#include "shm_ingest.hpp"
+#include "shm_publisher.hpp"
+
+#define TEST_OFFLINE_FRAMES 20
+#define TEST_ONLINE_FRAMES 2000
+#define TEST_BATCH_FRAMES 100      // меньше SMART_CLIENT_MAX_QUEUED_FRAMES: ingest не ждет клиента
+#define TEST_TIMEOUT_MS 5000
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& what) {
+    if (!condition) {
+        std::cerr << "[TEST] FAILED: " << what << std::endl;
+        failures++;
+    }
+}
+
+class NullLed : public LedDevice {
+public:
+    void switchON() override {}
+    void switchOFF() override {}
+    void blink(int) override {}
+};
+
+class LinkUp : public LinkMonitor {
+public:
+    bool isLinkUp() override { return true; }
+};
+
+// Коллектор на loopback: копит все байты единственного соединения
+class StreamCollector {
+public:
+    bool start() {
+        listen_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+        if (listen_fd_ < 0) return false;
+
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t len = sizeof(addr);
+        if (bind(listen_fd_, (struct sockaddr*)&addr, sizeof(addr)) < 0 || listen(listen_fd_, 1) < 0 ||
+            getsockname(listen_fd_, (struct sockaddr*)&addr, &len) < 0) {
+            return false;
+        }
+        port_ = ntohs(addr.sin_port);
+
+        running_ = true;
+        thread_ = std::thread(&StreamCollector::loop, this);
+        return true;
+    }
+
+    void stop() {
+        running_ = false;
+        if (thread_.joinable()) thread_.join();
+        if (listen_fd_ >= 0) ::close(listen_fd_);
+    }
+
+    int port() const { return port_; }
+
+    // Ждет, пока придет size байт (false по таймауту)
+    bool waitBytes(size_t size, std::string& received) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(TEST_TIMEOUT_MS);
+        while (std::chrono::steady_clock::now() < deadline) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (data_.size() >= size) break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        received = data_;
+        return data_.size() >= size;
+    }
+
+private:
+    int listen_fd_ = -1;
+    int port_ = 0;
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+    std::mutex mutex_;
+    std::string data_;
+
+    void loop() {
+        int conn = -1;
+        char buffer[4096];
+        while (running_) {
+            struct pollfd pfd = {conn >= 0 ? conn : listen_fd_, POLLIN, 0};
+            if (poll(&pfd, 1, 20) <= 0) continue;
+
+            if (conn < 0) {
+                conn = accept(listen_fd_, nullptr, nullptr);
+                continue;
+            }
+            ssize_t received = recv(conn, buffer, sizeof(buffer), 0);
+            if (received <= 0) break;
+            std::lock_guard<std::mutex> lock(mutex_);
+            data_.append(buffer, received);
+        }
+        if (conn >= 0) ::close(conn);
+    }
+};
+
+static std::string frameText(int index) {
+    char text[32];
+    snprintf(text, sizeof(text), "frame-%05d\n", index);
+    return text;
+}
+
+// Публикует кадры first..first+count-1; при полном кольце ждет ingest
+static bool publishFrames(ShmPublisher& publisher, int first, int count) {
+    for (int i = first; i < first + count; i++) {
+        const std::string text = frameText(i);
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(TEST_TIMEOUT_MS);
+        while (!publisher.publish(reinterpret_cast<const uint8_t*>(text.data()), text.size())) {
+            if (std::chrono::steady_clock::now() > deadline) return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    return true;
+}
+
+// Ждет, пока ingest разберет count кадров (приняты + потеряны)
+static bool waitIngested(const ShmIngest& ingest, uint64_t count) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(TEST_TIMEOUT_MS);
+    while (std::chrono::steady_clock::now() < deadline) {
+        ShmIngestStats stats = ingest.getStats();
+        if (stats.frames + stats.dropped_frames >= count) return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return false;
+}
+
+int main() {
+    const std::string socket_path = "/tmp/button-led-test-ingest-" + std::to_string(getpid()) + ".sock";
+
+    StreamCollector collector;
+    check(collector.start(), "collector start");
+
+    NullLed led1, led2;
+    LinkUp link;
+    SmartClient client;
+    client.setupLed(&led1, &led2);
+    client.setupLinkMonitor(&link);
+    client.setAckWindow(0);   // без кодеков и ACK - без HELLO, поток байт как есть
+
+    ShmIngest ingest(socket_path);
+    // Тот же sink, что в main() button-led
+    check(ingest.start([&client](const uint8_t* data, size_t size, uint64_t trace_id) {
+        if (!client.isRunning()) return false;
+        return client.sendData(data, size, trace_id);
+    }), "ingest start");
+
+    ShmPublisher publisher;
+    check(publisher.connect(socket_path), "publisher connect");
+
+    // Клиент еще не подключен: кадры теряются, но считаются
+    check(publishFrames(publisher, 0, TEST_OFFLINE_FRAMES), "publish offline");
+    check(waitIngested(ingest, TEST_OFFLINE_FRAMES), "ingest drained offline frames");
+    check(ingest.getStats().dropped_frames == TEST_OFFLINE_FRAMES,
+          "offline frames not counted as dropped: " + std::to_string(ingest.getStats().dropped_frames));
+
+    check(client.start("127.0.0.1", collector.port()), "client start");
+
+    // Пачками: очередь клиента ограничена, а ingest отдает кадры без ожидания
+    std::string expected;
+    std::string received;
+    bool delivered = true;
+    for (int first = TEST_OFFLINE_FRAMES; delivered && first < TEST_OFFLINE_FRAMES + TEST_ONLINE_FRAMES;
+         first += TEST_BATCH_FRAMES) {
+        for (int i = first; i < first + TEST_BATCH_FRAMES; i++) expected += frameText(i);
+        delivered = publishFrames(publisher, first, TEST_BATCH_FRAMES) &&
+                    collector.waitBytes(expected.size(), received);
+    }
+    check(delivered, "collector got " + std::to_string(received.size()) + " of " +
+                     std::to_string(expected.size()) + " bytes");
+    // Между пачками клиент мог успеть послать PING - его пропускаем
+    std::string payload;
+    for (size_t pos = 0; pos < received.size();) {
+        if (received.compare(pos, 5, "PING#") == 0) {
+            size_t eol = received.find('\n', pos);
+            pos = eol == std::string::npos ? received.size() : eol + 1;
+            continue;
+        }
+        payload += received[pos++];
+    }
+    check(payload == expected, "stream differs from published frames");
+
+    ShmIngestStats stats = ingest.getStats();
+    check(stats.frames == TEST_ONLINE_FRAMES, "ingest frames: " + std::to_string(stats.frames));
+    check(stats.dropped_frames == TEST_OFFLINE_FRAMES, "drops while online");
+    check(stats.protocol_errors == 0, "protocol errors");
+    check(stats.ring_full == 0, "ring full without dropped frames");
+
+    // Издатель отказался от кадра: button-led считает его один раз
+    publisher.dropFrame();
+    const std::string last = frameText(TEST_OFFLINE_FRAMES + TEST_ONLINE_FRAMES);
+    check(publishFrames(publisher, TEST_OFFLINE_FRAMES + TEST_ONLINE_FRAMES, 1) &&
+          waitIngested(ingest, TEST_OFFLINE_FRAMES + TEST_ONLINE_FRAMES + 1), "publish after drop");
+    check(ingest.getStats().ring_full == 1, "dropped frame counted as ring full " +
+          std::to_string(ingest.getStats().ring_full) + " times");
+
+    publisher.close();
+    client.stop();
+    ingest.stop();
+    collector.stop();
+    unlink(socket_path.c_str());
+
+    if (failures) {
+        std::cerr << "[TEST] " << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "[TEST] shm ingest: " << stats.frames << " frames delivered, "
+              << stats.dropped_frames << " offline frames counted as dropped" << std::endl;
+    return 0;
+}
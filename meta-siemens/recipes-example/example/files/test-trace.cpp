@@ -0,0 +1,90 @@
+/*
+ * test-trace: дамп колец трассировки.
+ *   - кольцо завершившегося потока достается новому без старых событий;
+ *   - дамп во время записи не выдает "разорванных" событий: у каждого
+ *     события имя и id записаны вместе (четный id - "even", нечетный - "odd").
+ *
+ * Код возврата 1, если не прошла хоть одна проверка (запускается из ctest).
+ */
+
+#include <iostream>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include "trace.hpp"
+
+#define TEST_TRACE_PATH "/tmp/button-led-test-trace.json"
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& what) {
+    if (!condition) {
+        std::cerr << "[TEST] FAILED: " << what << std::endl;
+        failures++;
+    }
+}
+
+// Число событий с именем name; mismatched - события с неверной четностью id
+static size_t countEvents(const char* name, size_t* mismatched = nullptr) {
+    FILE* file = fopen(TEST_TRACE_PATH, "r");
+    if (file == nullptr) return 0;
+
+    size_t count = 0;
+    char line[512];
+    char pattern[64];
+    snprintf(pattern, sizeof(pattern), "{\"name\":\"%s\"", name);
+    while (fgets(line, sizeof(line), file)) {
+        if (strncmp(line, pattern, strlen(pattern)) != 0) continue;
+        count++;
+        const char* args = strstr(line, "\"id\":");
+        unsigned long long id = args ? strtoull(args + 5, nullptr, 10) : 0;
+        bool even = strcmp(name, "even") == 0;
+        if (mismatched && (id % 2 == 0) != even) (*mismatched)++;
+    }
+    fclose(file);
+    return count;
+}
+
+int main() {
+    // Поток заполняет кольцо с переполнением и завершается
+    std::thread first([]() {
+        for (int i = 0; i < TRACE_EVENTS_PER_THREAD * 2; i++) Tracer::record("old_owner", 'i', i);
+    });
+    first.join();
+
+    // Следующий поток получает то же кольцо
+    std::thread second([]() { Tracer::record("new_owner", 'i', 1); });
+    second.join();
+
+    check(Tracer::dumpChromeJson(TEST_TRACE_PATH), "dump");
+    check(countEvents("new_owner") == 1, "new owner event missing");
+    check(countEvents("old_owner") == 0, "reused ring kept events of the previous thread");
+
+    // Дамп на ходу: писатель все время перезаписывает кольцо
+    std::atomic<bool> running{true};
+    std::thread writer([&running]() {
+        for (uint64_t id = 0; running; id++) Tracer::record(id % 2 ? "odd" : "even", 'i', id);
+    });
+
+    size_t events = 0, mismatched = 0;
+    for (int round = 0; round < 50; round++) {
+        check(Tracer::dumpChromeJson(TEST_TRACE_PATH), "dump while writing");
+        events += countEvents("even", &mismatched) + countEvents("odd", &mismatched);
+    }
+    running = false;
+    writer.join();
+
+    check(events > 0, "no events dumped while writing");
+    check(mismatched == 0, "torn events in dump: " + std::to_string(mismatched));
+    remove(TEST_TRACE_PATH);
+
+    if (failures) {
+        std::cerr << "[TEST] " << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "[TEST] trace dump: " << events << " events, none torn" << std::endl;
+    return 0;
+}
@@ -0,0 +1,217 @@
+#include <atomic>
+#include <cstdio>
+#include <iostream>
+#include <mutex>
+#include <ctime>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+#include "trace.hpp"
+
+struct TraceEvent {
+    uint64_t ts_ns;
+    uint64_t id;
+    const char* name;
+    uint32_t tid;
+    char phase;
+};
+
+struct TraceRing {
+    std::atomic<bool> claimed{false};
+    std::atomic<uint64_t> generation{0};   // +1 при каждом захвате кольца потоком
+    std::atomic<uint64_t> head{0};
+    uint32_t tid = 0;
+    const char* thread_name = nullptr;
+    TraceEvent events[TRACE_EVENTS_PER_THREAD];
+};
+
+static TraceRing g_rings[TRACE_MAX_THREADS];
+static std::atomic<uint64_t> g_next_id{1};
+static std::atomic<uint64_t> g_dropped{0};
+static std::atomic<bool> g_enabled{true};
+static std::atomic<bool> g_dump_requested{false};
+
+// Копия кольца для дампа: писатели продолжают писать, пока файл сохраняется
+static TraceEvent g_snapshot[TRACE_EVENTS_PER_THREAD];
+static std::mutex g_snapshot_mutex;
+
+// Кольцо освобождается при завершении потока и достается следующему
+struct ThreadRing {
+    TraceRing* ring = nullptr;
+    uint32_t tid = 0;
+
+    ~ThreadRing() {
+        if (ring) ring->claimed = false;
+    }
+};
+
+static thread_local ThreadRing t_ring;
+
+static uint64_t monotonic_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + ts.tv_nsec;
+}
+
+static TraceRing* thread_ring() {
+    if (t_ring.ring) return t_ring.ring;
+
+    t_ring.tid = static_cast<uint32_t>(syscall(SYS_gettid));
+    for (auto& ring : g_rings) {
+        bool expected = false;
+        if (ring.claimed.compare_exchange_strong(expected, true)) {
+            // События прежнего владельца к новому потоку не относятся
+            ring.head.store(0, std::memory_order_relaxed);
+            ring.tid = t_ring.tid;
+            ring.thread_name = nullptr;
+            ring.generation.fetch_add(1, std::memory_order_release);
+            t_ring.ring = &ring;
+            break;
+        }
+    }
+    return t_ring.ring;
+}
+
+uint64_t Tracer::newEventId() {
+    return g_next_id.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Tracer::setEnabled(bool enabled) {
+    g_enabled = enabled;
+}
+
+bool Tracer::isEnabled() {
+    return g_enabled;
+}
+
+void Tracer::setThreadName(const char* name) {
+    TraceRing* ring = thread_ring();
+    if (ring) ring->thread_name = name;
+}
+
+void Tracer::record(const char* name, char phase, uint64_t id) {
+    if (!g_enabled.load(std::memory_order_relaxed)) return;
+
+    TraceRing* ring = thread_ring();
+    if (ring == nullptr) {
+        g_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    uint64_t head = ring->head.load(std::memory_order_relaxed);
+    TraceEvent& event = ring->events[head % TRACE_EVENTS_PER_THREAD];
+    event.ts_ns = monotonic_ns();
+    event.id = id;
+    event.name = name;
+    event.tid = t_ring.tid;
+    event.phase = phase;
+    ring->head.store(head + 1, std::memory_order_release);
+}
+
+void Tracer::requestDump() {
+    g_dump_requested = true;
+}
+
+bool Tracer::dumpIfRequested(const char* path) {
+    if (!g_dump_requested.exchange(false)) return false;
+    return dumpChromeJson(path);
+}
+
+bool Tracer::dumpChromeJson(const char* path) {
+    FILE* file = fopen(path, "w");
+    if (file == nullptr) {
+        std::cerr << "[TRACE] Failed to open " << path << std::endl;
+        return false;
+    }
+
+    const int pid = getpid();
+    size_t written = 0;
+    bool first = true;
+
+    fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+
+    std::lock_guard<std::mutex> lock(g_snapshot_mutex);
+    for (auto& ring : g_rings) {
+        const uint64_t generation = ring.generation.load(std::memory_order_acquire);
+        const uint64_t head = ring.head.load(std::memory_order_acquire);
+        if (head == 0) continue;
+
+        const uint32_t tid = ring.tid;
+        const char* thread_name = ring.thread_name;
+        uint64_t begin = head > TRACE_EVENTS_PER_THREAD ? head - TRACE_EVENTS_PER_THREAD : 0;
+        for (uint64_t i = begin; i < head; i++) {
+            g_snapshot[i % TRACE_EVENTS_PER_THREAD] = ring.events[i % TRACE_EVENTS_PER_THREAD];
+        }
+
+        // Пока копировали, писатель ушел вперед: слоты в пределах длины кольца
+        // от его текущего head могли быть перезаписаны посреди копирования
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t head_after = ring.head.load(std::memory_order_relaxed);
+        if (ring.generation.load(std::memory_order_relaxed) != generation || head_after < head) {
+            continue;   // кольцо за это время досталось другому потоку
+        }
+        if (head_after >= TRACE_EVENTS_PER_THREAD && head_after - TRACE_EVENTS_PER_THREAD + 1 > begin) {
+            begin = head_after - TRACE_EVENTS_PER_THREAD + 1;
+        }
+
+        if (thread_name) {
+            fprintf(file, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%u,"
+                          "\"args\":{\"name\":\"%s\"}}",
+                    first ? "" : ",", pid, tid, thread_name);
+            first = false;
+        }
+
+        for (uint64_t i = begin; i < head; i++) {
+            const TraceEvent& event = g_snapshot[i % TRACE_EVENTS_PER_THREAD];
+            const double ts_us = event.ts_ns / 1000.0;
+
+            if (event.phase == 's' || event.phase == 't' || event.phase == 'f') {
+                // Flow привязывается к охватывающему срезу (bp:e)
+                fprintf(file, "%s\n{\"name\":\"event\",\"cat\":\"flow\",\"ph\":\"%c\",\"id\":%llu,"
+                              "\"ts\":%.3f,\"pid\":%d,\"tid\":%u,\"bp\":\"e\"}",
+                        first ? "" : ",", event.phase, (unsigned long long)event.id,
+                        ts_us, pid, event.tid);
+            } else {
+                fprintf(file, "%s\n{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":%d,\"tid\":%u,"
+                              "\"args\":{\"id\":%llu}}",
+                        first ? "" : ",", event.name, event.phase, ts_us, pid, event.tid,
+                        (unsigned long long)event.id);
+            }
+            first = false;
+            written++;
+        }
+    }
+
+    fprintf(file, "\n],\"otherData\":{\"dropped\":%llu}}\n",
+            (unsigned long long)g_dropped.load());
+    fclose(file);
+
+    std::cout << "[TRACE] " << written << " events written to " << path << std::endl;
+    return true;
+}
+
+TraceScope::TraceScope(const char* name, uint64_t id, trace_flow_e flow)
+    : name_(name), id_(id) {
+    Tracer::record(name_, 'B', id_);
+
+    // id 0 - событие без источника, связывать не с чем
+    if (id_ == 0) return;
+
+    switch (flow) {
+        case TRACE_FLOW_START:
+            Tracer::record(name_, 's', id_);
+            break;
+        case TRACE_FLOW_STEP:
+            Tracer::record(name_, 't', id_);
+            break;
+        case TRACE_FLOW_END:
+            Tracer::record(name_, 'f', id_);
+            break;
+        case TRACE_FLOW_NONE:
+            break;
+    }
+}
+
+TraceScope::~TraceScope() {
+    Tracer::record(name_, 'E', id_);
+}
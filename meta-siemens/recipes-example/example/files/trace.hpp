@@ -0,0 +1,65 @@
+#ifndef TRACE_MODULE_HPP
+#define TRACE_MODULE_HPP
+
+#include <cstdint>
+
+#define TRACE_MAX_THREADS 16
+#define TRACE_EVENTS_PER_THREAD 2048
+#define TRACE_DEFAULT_PATH "/tmp/button-led-trace.json"
+
+enum trace_flow_e {
+    TRACE_FLOW_NONE,
+    TRACE_FLOW_START,   // событие родилось (фронт GPIO, отсчет датчика)
+    TRACE_FLOW_STEP,    // промежуточная стадия
+    TRACE_FLOW_END      // событие доставлено / подтверждено
+};
+
+/*
+ * Трассировка с малыми накладными расходами.
+ *
+ * Каждый поток пишет в свое кольцо из статического пула (без malloc и без
+ * блокировок): метка CLOCK_MONOTONIC, id события, имя стадии. Стадии одного
+ * события связываются общим id в поток (flow) Chrome/Perfetto.
+ * dumpChromeJson() сохраняет все кольца в JSON для chrome://tracing / ui.perfetto.dev.
+ */
+class Tracer {
+public:
+    static uint64_t newEventId();
+
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+    static void setThreadName(const char* name);
+
+    static void record(const char* name, char phase, uint64_t id);
+
+    // requestDump() можно вызывать из обработчика сигнала
+    static void requestDump();
+    static bool dumpIfRequested(const char* path);
+    static bool dumpChromeJson(const char* path);
+};
+
+// Стадия события: срез B/E на текущем потоке + связь по id
+class TraceScope {
+public:
+    TraceScope(const char* name, uint64_t id, trace_flow_e flow = TRACE_FLOW_NONE);
+    ~TraceScope();
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name_;
+    uint64_t id_;
+};
+
+#ifdef BUTTON_LED_TRACING
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name, id, flow) TraceScope TRACE_CONCAT(trace_scope_, __LINE__)(name, id, flow)
+#define TRACE_NEW_ID() Tracer::newEventId()
+#else
+#define TRACE_SCOPE(name, id, flow) do { (void)(id); } while (0)
+#define TRACE_NEW_ID() 0
+#endif
+
+#endif
@@ -0,0 +1,622 @@
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+
+#include "uring.hpp"
+
+#ifdef BUTTON_LED_IO_URING
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#define URING_TAG_IO 1
+#define URING_TAG_CANCEL 2
+
+static int sys_io_uring_setup(unsigned int entries, struct io_uring_params* params) {
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+static int sys_io_uring_enter(int fd, unsigned int to_submit, unsigned int min_complete,
+                              unsigned int flags, const void* arg, size_t arg_size) {
+    return static_cast<int>(syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, arg, arg_size));
+}
+
+static int sys_io_uring_register(int fd, unsigned int opcode, const void* arg, unsigned int nr_args) {
+    return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+}
+
+static uint64_t monotonic_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + ts.tv_nsec;
+}
+
+static UringSupport probeKernel() {
+    UringSupport result;
+
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    int fd = sys_io_uring_setup(4, &params);
+    if (fd < 0) {
+        // ENOSYS - ядро без io_uring, EPERM - kernel.io_uring_disabled или seccomp
+        result.reason = std::string("io_uring_setup: ") + strerror(errno);
+        return result;
+    }
+
+    // SINGLE_MMAP - 5.4, EXT_ARG (таймаут ожидания) - 5.11
+    if (!(params.features & IORING_FEAT_SINGLE_MMAP) || !(params.features & IORING_FEAT_EXT_ARG)) {
+        result.reason = "kernel older than 5.11 (no IORING_FEAT_EXT_ARG)";
+        close(fd);
+        return result;
+    }
+
+    alignas(struct io_uring_probe) uint8_t probe_buf[sizeof(struct io_uring_probe) +
+                                                      256 * sizeof(struct io_uring_probe_op)];
+    memset(probe_buf, 0, sizeof(probe_buf));
+    auto* probe = reinterpret_cast<struct io_uring_probe*>(probe_buf);
+    if (sys_io_uring_register(fd, IORING_REGISTER_PROBE, probe, 256) < 0) {
+        result.reason = std::string("IORING_REGISTER_PROBE: ") + strerror(errno);
+        close(fd);
+        return result;
+    }
+
+    auto supported = [probe](unsigned int op) {
+        return op <= probe->last_op && (probe->ops[op].flags & IO_URING_OP_SUPPORTED);
+    };
+    const unsigned int required[] = {
+        IORING_OP_SEND, IORING_OP_RECV,
+        IORING_OP_ASYNC_CANCEL,
+    };
+    for (unsigned int op : required) {
+        if (!supported(op)) {
+            result.reason = "missing io_uring opcode " + std::to_string(op);
+            close(fd);
+            return result;
+        }
+    }
+
+    // Кольцо provided buffers - 5.19
+    void* ring = mmap(nullptr, sizeof(struct io_uring_buf), PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ring == MAP_FAILED) {
+        result.reason = std::string("mmap: ") + strerror(errno);
+        close(fd);
+        return result;
+    }
+    struct io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = reinterpret_cast<uintptr_t>(ring);
+    reg.ring_entries = 1;
+    reg.bgid = URING_RECV_BUFFER_GROUP;
+    bool buffer_ring = sys_io_uring_register(fd, IORING_REGISTER_PBUF_RING, &reg, 1) == 0;
+    munmap(ring, sizeof(struct io_uring_buf));
+
+    if (!buffer_ring) {
+        result.reason = "kernel older than 5.19 (no provided buffer rings)";
+        close(fd);
+        return result;
+    }
+
+    // Отдельного признака нет: multishot RECV появился в 6.0 вместе с SEND_ZC.
+    // Если догадка неверна, UringReceiver увидит -EINVAL и перейдет на одиночные RECV.
+    result.multishot_recv = supported(IORING_OP_SEND_ZC);
+    result.available = true;
+    close(fd);
+    return result;
+}
+
+const UringSupport& uringProbe() {
+    static const UringSupport support = probeKernel();
+    return support;
+}
+
+UringQueue::~UringQueue() {
+    close();
+}
+
+bool UringQueue::init(unsigned int entries) {
+    close();
+
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    // Кольцо живет в одном потоке: завершения обрабатываются только при ожидании
+    params.flags = IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_DEFER_TASKRUN;
+    int fd = sys_io_uring_setup(entries, &params);
+    if (fd < 0 && errno == EINVAL) {
+        // До 6.1 этих флагов нет
+        memset(&params, 0, sizeof(params));
+        fd = sys_io_uring_setup(entries, &params);
+    }
+    if (fd < 0) {
+        return false;
+    }
+    if (!(params.features & IORING_FEAT_SINGLE_MMAP) || !(params.features & IORING_FEAT_EXT_ARG)) {
+        ::close(fd);
+        errno = ENOSYS;
+        return false;
+    }
+
+    size_t sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+    size_t cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    ring_size_ = sq_size > cq_size ? sq_size : cq_size;
+    void* ring = mmap(nullptr, ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      fd, IORING_OFF_SQ_RING);
+    if (ring == MAP_FAILED) {
+        ::close(fd);
+        return false;
+    }
+
+    sqes_size_ = params.sq_entries * sizeof(struct io_uring_sqe);
+    void* sqes = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        munmap(ring, ring_size_);
+        ::close(fd);
+        return false;
+    }
+
+    ring_fd_ = fd;
+    ring_ptr_ = ring;
+    sqes_ = static_cast<struct io_uring_sqe*>(sqes);
+
+    uint8_t* base = static_cast<uint8_t*>(ring);
+    sq_head_ = reinterpret_cast<unsigned int*>(base + params.sq_off.head);
+    sq_tail_ = reinterpret_cast<unsigned int*>(base + params.sq_off.tail);
+    sq_mask_ = *reinterpret_cast<unsigned int*>(base + params.sq_off.ring_mask);
+    sq_entries_ = params.sq_entries;
+    cq_head_ = reinterpret_cast<unsigned int*>(base + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned int*>(base + params.cq_off.tail);
+    cq_mask_ = *reinterpret_cast<unsigned int*>(base + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<struct io_uring_cqe*>(base + params.cq_off.cqes);
+
+    // Индексы SQ указывают на SQE с тем же номером
+    unsigned int* array = reinterpret_cast<unsigned int*>(base + params.sq_off.array);
+    for (unsigned int i = 0; i < sq_entries_; i++) {
+        array[i] = i;
+    }
+    sqe_tail_ = *sq_tail_;
+    files_registered_ = false;
+    syscalls_ = 0;
+    return true;
+}
+
+void UringQueue::close() {
+    if (ring_fd_ < 0) return;
+
+    munmap(sqes_, sqes_size_);
+    munmap(ring_ptr_, ring_size_);
+    ::close(ring_fd_);
+    ring_fd_ = -1;
+    ring_ptr_ = nullptr;
+    sqes_ = nullptr;
+    cqes_ = nullptr;
+    files_registered_ = false;
+}
+
+struct io_uring_sqe* UringQueue::getSqe() {
+    unsigned int head = __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+    if (sqe_tail_ - head >= sq_entries_) {
+        return nullptr;
+    }
+
+    struct io_uring_sqe* sqe = &sqes_[sqe_tail_ & sq_mask_];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe_tail_++;
+    return sqe;
+}
+
+int UringQueue::submitAndWait(unsigned int wait_nr, int timeout_ms) {
+    __atomic_store_n(sq_tail_, sqe_tail_, __ATOMIC_RELEASE);
+
+    struct __kernel_timespec ts;
+    struct io_uring_getevents_arg arg;
+    memset(&arg, 0, sizeof(arg));
+    unsigned int flags = IORING_ENTER_GETEVENTS;
+    const void* arg_ptr = nullptr;
+    size_t arg_size = 0;
+    if (timeout_ms >= 0 && wait_nr > 0) {
+        ts.tv_sec = timeout_ms / 1000;
+        ts.tv_nsec = static_cast<long long>(timeout_ms % 1000) * 1000000;
+        arg.ts = reinterpret_cast<uintptr_t>(&ts);
+        flags |= IORING_ENTER_EXT_ARG;
+        arg_ptr = &arg;
+        arg_size = sizeof(arg);
+    }
+
+    for (;;) {
+        unsigned int to_submit = sqe_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+        syscalls_++;
+        int ret = sys_io_uring_enter(ring_fd_, to_submit, wait_nr, flags, arg_ptr, arg_size);
+        if (ret >= 0) return 0;
+        if (errno == EINTR) continue;
+        return -errno;
+    }
+}
+
+struct io_uring_cqe* UringQueue::peekCqe() {
+    unsigned int head = *cq_head_;
+    if (head == __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) {
+        return nullptr;
+    }
+    return &cqes_[head & cq_mask_];
+}
+
+int UringQueue::waitCqe(struct io_uring_cqe*& cqe, int timeout_ms) {
+    cqe = peekCqe();
+    if (cqe != nullptr) return 0;
+
+    // Если enter что-то отправил, он возвращает число отправленных даже по
+    // таймауту - поэтому считаем срок сами
+    uint64_t deadline_ns = timeout_ms >= 0 ? monotonic_ns() + static_cast<uint64_t>(timeout_ms) * 1000000ull : 0;
+    for (;;) {
+        int wait_ms = -1;
+        if (timeout_ms >= 0) {
+            uint64_t now = monotonic_ns();
+            if (now >= deadline_ns) return -ETIME;
+            wait_ms = static_cast<int>((deadline_ns - now + 999999) / 1000000);
+        }
+
+        int ret = submitAndWait(1, wait_ms);
+        cqe = peekCqe();
+        if (cqe != nullptr) return 0;
+        if (ret < 0 && ret != -ETIME) return ret;
+    }
+}
+
+void UringQueue::seenCqe() {
+    __atomic_store_n(cq_head_, *cq_head_ + 1, __ATOMIC_RELEASE);
+}
+
+bool UringQueue::setFile(int fd) {
+    syscalls_++;
+    if (!files_registered_) {
+        if (sys_io_uring_register(ring_fd_, IORING_REGISTER_FILES, &fd, 1) < 0) {
+            return false;
+        }
+        files_registered_ = true;
+        return true;
+    }
+
+    // Ссылку на старый сокет держат только еще не завершенные запросы
+    struct io_uring_files_update update;
+    memset(&update, 0, sizeof(update));
+    update.offset = 0;
+    update.fds = reinterpret_cast<uintptr_t>(&fd);
+    return sys_io_uring_register(ring_fd_, IORING_REGISTER_FILES_UPDATE, &update, 1) == 1;
+}
+
+
+bool UringQueue::registerBufferRing(void* ring, unsigned int entries, uint16_t group) {
+    struct io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = reinterpret_cast<uintptr_t>(ring);
+    reg.ring_entries = entries;
+    reg.bgid = group;
+    syscalls_++;
+    return sys_io_uring_register(ring_fd_, IORING_REGISTER_PBUF_RING, &reg, 1) == 0;
+}
+
+bool UringSender::init() {
+    if (!uringProbe().available) {
+        errno = ENOSYS;
+        return false;
+    }
+    return queue_.init(URING_QUEUE_DEPTH);
+}
+
+bool UringSender::attach(int fd) {
+    if (!queue_.isValid() && !init()) return false;
+    return queue_.setFile(fd);
+}
+
+// Отмена зависшей записи; false - места под SQE так и не нашлось
+bool UringSender::submitCancel() {
+    struct io_uring_sqe* cancel = queue_.getSqe();
+    if (cancel == nullptr) {
+        // Очередь полна: отдаем ядру подготовленное и пробуем еще раз
+        queue_.submitAndWait(0, -1);
+        cancel = queue_.getSqe();
+        if (cancel == nullptr) return false;
+    }
+    cancel->opcode = IORING_OP_ASYNC_CANCEL;
+    cancel->fd = -1;
+    cancel->addr = URING_TAG_IO;
+    cancel->user_data = URING_TAG_CANCEL;
+    return true;
+}
+
+// Запись не завершилась и после отмены: закрываем кольцо (ядро отменит
+// запрос вместе с ним), поток отправки считает соединение мертвым.
+// Следующий attach() создаст кольцо заново
+bool UringSender::abandon() {
+    queue_.close();
+    errno = ETIMEDOUT;
+    return false;
+}
+
+bool UringSender::send(const uint8_t* data, size_t size, int timeout_ms) {
+    uint64_t deadline_ns = monotonic_ns() + static_cast<uint64_t>(timeout_ms) * 1000000ull;
+
+    size_t total_sent = 0;
+    while (total_sent < size) {
+        const uint8_t* chunk = data + total_sent;
+        size_t length = size - total_sent;
+
+        struct io_uring_sqe* sqe = queue_.getSqe();
+        if (sqe == nullptr) {
+            errno = EBUSY;
+            return false;
+        }
+        // WRITE_FIXED из зарегистрированного буфера на TCP медленнее SEND (идет
+        // через общий путь read/write), а SEND с зарегистрированным буфером
+        // есть только в zero-copy варианте - для кадров в сотни байт он не окупается
+        sqe->opcode = IORING_OP_SEND;
+        sqe->msg_flags = MSG_NOSIGNAL;
+        sqe->fd = 0;
+        sqe->flags = IOSQE_FIXED_FILE;
+        sqe->addr = reinterpret_cast<uintptr_t>(chunk);
+        sqe->len = static_cast<uint32_t>(length);
+        sqe->user_data = URING_TAG_IO;
+
+        // Вместо setsockopt(SO_SNDTIMEO) до и после send - таймаут ожидания;
+        // LINK_TIMEOUT на каждый кадр заводил бы таймер в ядре
+        int io_result = 0;
+        bool cancelled = false;
+        uint64_t wait_deadline_ns = deadline_ns;
+        for (;;) {
+            uint64_t now = monotonic_ns();
+            int remaining_ms = now < wait_deadline_ns ?
+                static_cast<int>((wait_deadline_ns - now + 999999) / 1000000) : 0;
+
+            struct io_uring_cqe* cqe = nullptr;
+            int ret = queue_.waitCqe(cqe, remaining_ms);
+            if (ret == -ETIME) {
+                // Отмена тоже не дождалась завершения - как SO_SNDTIMEO, не висим
+                if (cancelled || !submitCancel()) {
+                    return abandon();
+                }
+                // Сокет не принял данные вовремя: отменяем и ждем завершения
+                // записи не дольше исходного таймаута
+                cancelled = true;
+                wait_deadline_ns = monotonic_ns() + static_cast<uint64_t>(timeout_ms) * 1000000ull;
+                continue;
+            }
+            if (ret < 0) {
+                errno = -ret;
+                return false;
+            }
+
+            uint64_t tag = cqe->user_data;
+            int result = cqe->res;
+            queue_.seenCqe();
+            if (tag == URING_TAG_IO) {
+                io_result = result;
+                break;
+            }
+        }
+
+        if (io_result == -ECANCELED || io_result == -EINTR) {
+            errno = ETIMEDOUT;
+            return false;
+        }
+        if (io_result < 0) {
+            errno = -io_result;
+            return false;
+        }
+        if (io_result == 0) {
+            errno = ECONNRESET;
+            return false;
+        }
+        total_sent += io_result;
+    }
+    return true;
+}
+
+void UringSender::close() {
+    queue_.close();
+}
+
+UringReceiver::~UringReceiver() {
+    close();
+}
+
+bool UringReceiver::init() {
+    close();
+
+    const UringSupport& support = uringProbe();
+    if (!support.available) {
+        errno = ENOSYS;
+        return false;
+    }
+    if (!queue_.init(URING_QUEUE_DEPTH)) {
+        return false;
+    }
+
+    void* ring = mmap(nullptr, URING_RECV_BUFFERS * sizeof(struct io_uring_buf), PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    void* buffers = mmap(nullptr, URING_RECV_BUFFERS * URING_RECV_BUFFER_BYTES, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    buffer_ring_ = ring == MAP_FAILED ? nullptr : ring;
+    buffers_ = buffers == MAP_FAILED ? nullptr : static_cast<uint8_t*>(buffers);
+    if (buffer_ring_ == nullptr || buffers_ == nullptr ||
+        !queue_.registerBufferRing(buffer_ring_, URING_RECV_BUFFERS, URING_RECV_BUFFER_GROUP)) {
+        int err = errno;
+        close();
+        errno = err;
+        return false;
+    }
+
+    buffer_tail_ = 0;
+    for (uint16_t i = 0; i < URING_RECV_BUFFERS; i++) {
+        recycle(i);
+    }
+
+    multishot_ = support.multishot_recv;
+    armed_ = false;
+    request_id_ = 0;
+    held_buffer_ = -1;
+    return true;
+}
+
+bool UringReceiver::attach(int fd) {
+    release();
+    if (!queue_.setFile(fd)) {
+        return false;
+    }
+
+    // Старый RECV мог остаться на сокете, который не закрывался со стороны сервера
+    if (armed_) {
+        struct io_uring_sqe* sqe = queue_.getSqe();
+        if (sqe != nullptr) {
+            sqe->opcode = IORING_OP_ASYNC_CANCEL;
+            sqe->fd = -1;
+            sqe->addr = request_id_;
+            sqe->user_data = 0;
+        }
+        armed_ = false;
+    }
+    // Завершения со старым id отбрасываются в receive()
+    request_id_++;
+    return true;
+}
+
+bool UringReceiver::arm() {
+    struct io_uring_sqe* sqe = queue_.getSqe();
+    if (sqe == nullptr) {
+        errno = EBUSY;
+        return false;
+    }
+
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = 0;
+    sqe->flags = IOSQE_FIXED_FILE | IOSQE_BUFFER_SELECT;
+    sqe->buf_group = URING_RECV_BUFFER_GROUP;
+    sqe->ioprio = multishot_ ? IORING_RECV_MULTISHOT : 0;
+    sqe->user_data = request_id_;
+    armed_ = true;
+    return true;
+}
+
+ssize_t UringReceiver::receive(const uint8_t*& data, int timeout_ms) {
+    release();
+
+    for (;;) {
+        if (!armed_ && !arm()) {
+            return -errno;
+        }
+
+        struct io_uring_cqe* cqe = nullptr;
+        int ret = queue_.waitCqe(cqe, timeout_ms);
+        if (ret < 0) return ret;
+
+        uint64_t id = cqe->user_data;
+        int result = cqe->res;
+        uint32_t flags = cqe->flags;
+        queue_.seenCqe();
+
+        if (id != request_id_) {
+            // Отмена или хвост от прошлого сокета: буфер возвращаем в кольцо
+            if (flags & IORING_CQE_F_BUFFER) recycle(static_cast<uint16_t>(flags >> IORING_CQE_BUFFER_SHIFT));
+            continue;
+        }
+
+        if (!(flags & IORING_CQE_F_MORE)) {
+            armed_ = false;
+        }
+
+        if (result > 0 && (flags & IORING_CQE_F_BUFFER)) {
+            uint16_t buffer_id = static_cast<uint16_t>(flags >> IORING_CQE_BUFFER_SHIFT);
+            held_buffer_ = buffer_id;
+            data = buffers_ + static_cast<size_t>(buffer_id) * URING_RECV_BUFFER_BYTES;
+            return result;
+        }
+
+        if (flags & IORING_CQE_F_BUFFER) recycle(static_cast<uint16_t>(flags >> IORING_CQE_BUFFER_SHIFT));
+
+        if (result == -ENOBUFS) {
+            // Все буферы заняты - multishot остановился, ставим заново
+            continue;
+        }
+        if (result == -EINVAL && multishot_) {
+            std::cout << "[URING] Multishot recv not supported, using single-shot recv" << std::endl;
+            multishot_ = false;
+            continue;
+        }
+        return result;
+    }
+}
+
+void UringReceiver::release() {
+    if (held_buffer_ < 0) return;
+    recycle(static_cast<uint16_t>(held_buffer_));
+    held_buffer_ = -1;
+}
+
+void UringReceiver::recycle(uint16_t buffer_id) {
+    // Не через ring->bufs: в C++ пустая структура из __DECLARE_FLEX_ARRAY
+    // занимает байт и сдвигает массив на 8. Записи идут с начала кольца.
+    auto* ring = static_cast<struct io_uring_buf_ring*>(buffer_ring_);
+    struct io_uring_buf* buffer = static_cast<struct io_uring_buf*>(buffer_ring_) +
+                                  (buffer_tail_ & (URING_RECV_BUFFERS - 1));
+    buffer->addr = reinterpret_cast<uintptr_t>(buffers_ + static_cast<size_t>(buffer_id) * URING_RECV_BUFFER_BYTES);
+    buffer->len = URING_RECV_BUFFER_BYTES;
+    buffer->bid = buffer_id;
+    buffer_tail_++;
+    __atomic_store_n(&ring->tail, buffer_tail_, __ATOMIC_RELEASE);
+}
+
+void UringReceiver::close() {
+    queue_.close();
+    if (buffers_ != nullptr) {
+        munmap(buffers_, URING_RECV_BUFFERS * URING_RECV_BUFFER_BYTES);
+        buffers_ = nullptr;
+    }
+    if (buffer_ring_ != nullptr) {
+        munmap(buffer_ring_, URING_RECV_BUFFERS * sizeof(struct io_uring_buf));
+        buffer_ring_ = nullptr;
+    }
+    armed_ = false;
+    held_buffer_ = -1;
+}
+
+#else // !BUTTON_LED_IO_URING
+
+// Собрано без заголовков io_uring: всегда классические сокеты
+
+const UringSupport& uringProbe() {
+    static const UringSupport support = [] {
+        UringSupport result;
+        result.reason = "built without io_uring support";
+        return result;
+    }();
+    return support;
+}
+
+UringQueue::~UringQueue() {}
+bool UringQueue::init(unsigned int) { errno = ENOSYS; return false; }
+void UringQueue::close() {}
+struct io_uring_sqe* UringQueue::getSqe() { return nullptr; }
+int UringQueue::submitAndWait(unsigned int, int) { return -ENOSYS; }
+int UringQueue::waitCqe(struct io_uring_cqe*&, int) { return -ENOSYS; }
+struct io_uring_cqe* UringQueue::peekCqe() { return nullptr; }
+void UringQueue::seenCqe() {}
+bool UringQueue::setFile(int) { errno = ENOSYS; return false; }
+bool UringQueue::registerBufferRing(void*, unsigned int, uint16_t) { errno = ENOSYS; return false; }
+
+bool UringSender::init() { errno = ENOSYS; return false; }
+bool UringSender::attach(int) { errno = ENOSYS; return false; }
+bool UringSender::send(const uint8_t*, size_t, int) { errno = ENOSYS; return false; }
+void UringSender::close() {}
+
+UringReceiver::~UringReceiver() {}
+bool UringReceiver::init() { errno = ENOSYS; return false; }
+bool UringReceiver::attach(int) { errno = ENOSYS; return false; }
+ssize_t UringReceiver::receive(const uint8_t*&, int) { return -ENOSYS; }
+void UringReceiver::release() {}
+void UringReceiver::close() {}
+
+#endif
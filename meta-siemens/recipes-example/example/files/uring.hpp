@@ -0,0 +1,147 @@
+#ifndef URING_MODULE_HPP
+#define URING_MODULE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <sys/types.h>
+
+/*
+ * Сокетный ввод-вывод через io_uring (прямые системные вызовы, без liburing).
+ *
+ * Классический путь SmartClient на каждый кадр делает setsockopt + send +
+ * setsockopt, приемник - getsockopt + recv с SO_RCVTIMEO. Здесь:
+ *   UringSender   - SEND в зарегистрированный дескриптор, вместо SO_SNDTIMEO -
+ *                   таймаут ожидания и отмена: один io_uring_enter на кадр;
+ *   UringReceiver - один multishot RECV на соединение, данные в
+ *                   зарегистрированных буферах (кольцо provided buffers);
+ *                   io_uring_enter с таймаутом забирает все накопившиеся
+ *                   куски без копирования.
+ * Кольцо однопоточное (SINGLE_ISSUER): у отправителя и приемника свои,
+ * создаются в том потоке, который ими пользуется.
+ *
+ * Поддержка проверяется во время работы (uringProbe): ядро может быть старым,
+ * io_uring может быть выключен sysctl kernel.io_uring_disabled или seccomp.
+ * Без поддержки (или без BUTTON_LED_IO_URING при сборке) клиент остается на
+ * классических сокетах.
+ */
+
+#define URING_QUEUE_DEPTH 16
+#define URING_RECV_BUFFERS 16          // степень двойки
+#define URING_RECV_BUFFER_BYTES 2048
+#define URING_RECV_BUFFER_GROUP 1
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+struct UringSupport {
+    bool available = false;        // кольцо создается, нужные операции есть
+    bool multishot_recv = false;   // 6.0+, иначе RECV заново на каждый кусок
+    std::string reason;            // почему недоступно
+};
+
+// Результат кэшируется: проверка один раз на процесс
+const UringSupport& uringProbe();
+
+// Кольцо SQ/CQ без лишних абстракций
+class UringQueue {
+public:
+    UringQueue() = default;
+    ~UringQueue();
+
+    bool init(unsigned int entries);
+    void close();
+    bool isValid() const { return ring_fd_ >= 0; }
+
+    // nullptr - очередь заполнена (сначала submit)
+    struct io_uring_sqe* getSqe();
+    // Отправить подготовленные SQE и дождаться wait_nr завершений.
+    // timeout_ms < 0 - без таймаута. 0 или -errno (-ETIME по таймауту).
+    int submitAndWait(unsigned int wait_nr, int timeout_ms);
+    struct io_uring_cqe* peekCqe();
+    // Первое завершение (отправив подготовленные SQE); -ETIME по таймауту
+    int waitCqe(struct io_uring_cqe*& cqe, int timeout_ms);
+    void seenCqe();
+
+    // Слот 0 таблицы дескрипторов: первый вызов регистрирует, следующие - заменяют
+    bool setFile(int fd);
+    bool registerBufferRing(void* ring, unsigned int entries, uint16_t group);
+
+    uint64_t syscalls() const { return syscalls_; }
+
+    UringQueue(const UringQueue&) = delete;
+    UringQueue& operator=(const UringQueue&) = delete;
+
+private:
+    int ring_fd_ = -1;
+    void* ring_ptr_ = nullptr;
+    size_t ring_size_ = 0;
+    struct io_uring_sqe* sqes_ = nullptr;
+    size_t sqes_size_ = 0;
+
+    unsigned int* sq_head_ = nullptr;
+    unsigned int* sq_tail_ = nullptr;
+    unsigned int sq_mask_ = 0;
+    unsigned int sq_entries_ = 0;
+    unsigned int sqe_tail_ = 0;     // подготовлено, но еще не отдано ядру
+    unsigned int* cq_head_ = nullptr;
+    unsigned int* cq_tail_ = nullptr;
+    unsigned int cq_mask_ = 0;
+    struct io_uring_cqe* cqes_ = nullptr;
+
+    bool files_registered_ = false;
+    uint64_t syscalls_ = 0;
+};
+
+// Отправка по одному сокету (поток отправки)
+class UringSender {
+public:
+    bool init();
+    // После abandon() кольцо создается заново
+    bool attach(int fd);
+    // Отправить все байты; false - ошибка или таймаут (errno как у send())
+    bool send(const uint8_t* data, size_t size, int timeout_ms);
+    void close();
+
+    bool isValid() const { return queue_.isValid(); }
+    uint64_t syscalls() const { return queue_.syscalls(); }
+
+private:
+    UringQueue queue_;
+
+    bool submitCancel();
+    bool abandon();
+};
+
+// Прием по одному сокету (поток приема)
+class UringReceiver {
+public:
+    ~UringReceiver();
+
+    bool init();
+    // Новый сокет (после connect или failover): старый запрос отменяется
+    bool attach(int fd);
+    // > 0 - байт в data (до release()), 0 - соединение закрыто,
+    // < 0 - -errno, -ETIME по таймауту
+    ssize_t receive(const uint8_t*& data, int timeout_ms);
+    void release();
+    void close();
+
+    bool isValid() const { return queue_.isValid(); }
+    uint64_t syscalls() const { return queue_.syscalls(); }
+
+private:
+    UringQueue queue_;
+    uint8_t* buffers_ = nullptr;     // mmap: в рабочем цикле куча не нужна
+    void* buffer_ring_ = nullptr;
+    uint16_t buffer_tail_ = 0;
+    bool multishot_ = false;
+    bool armed_ = false;
+    uint64_t request_id_ = 0;        // user_data текущего RECV
+    int held_buffer_ = -1;
+
+    bool arm();
+    void recycle(uint16_t buffer_id);
+};
+
+#endif